@@ -1,3 +1,27 @@
-from .nanopandas_ext import StringArray, BoolArray, Int64Array, ExtensionArray
+from .nanopandas_ext import (
+    StringArray,
+    DictionaryStringArray,
+    StringViewArray,
+    BoolArray,
+    Int64Array,
+    ExtensionArray,
+    ChunkedBoolArray,
+    ChunkedInt64Array,
+    ChunkedStringArray,
+    get_num_threads,
+    set_num_threads,
+)
 
-__all__ = ["ExtensionArray", "StringArray", "BoolArray", "Int64Array"]
+__all__ = [
+    "ExtensionArray",
+    "StringArray",
+    "DictionaryStringArray",
+    "StringViewArray",
+    "BoolArray",
+    "Int64Array",
+    "ChunkedBoolArray",
+    "ChunkedInt64Array",
+    "ChunkedStringArray",
+    "get_num_threads",
+    "set_num_threads",
+]
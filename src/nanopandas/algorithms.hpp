@@ -1,5 +1,14 @@
 #pragma once
 
+#include "algorithms/arithmetic.hpp"
+#include "algorithms/chunked.hpp"
+#include "algorithms/compare.hpp"
+#include "algorithms/dictionary.hpp"
 #include "algorithms/generic.hpp"
+#include "algorithms/logical.hpp"
 #include "algorithms/numeric.hpp"
+#include "algorithms/numpy_.hpp"
+#include "algorithms/parallel.hpp"
+#include "algorithms/sort.hpp"
 #include "algorithms/string_.hpp"
+#include "algorithms/string_view.hpp"
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../array_types.hpp"
+#include "bitmap.hpp"
+#include "compare.hpp"
+#include "parallel.hpp"
+
+// Arithmetic operators. Apply stores left op right in out, wrapping around
+// on overflow, and returns whether it overflowed. Apply is called for every
+// row, including null ones and ones dividing by zero, so it must not trap
+// for any input
+struct ArithmeticAdd {
+  static constexpr const char *Name = "add";
+  static constexpr bool IsDivision = false;
+  static bool Apply(int64_t left, int64_t right, int64_t &out) {
+    out = static_cast<int64_t>(static_cast<uint64_t>(left) +
+                               static_cast<uint64_t>(right));
+    return ((left ^ out) & (right ^ out)) < 0;
+  }
+};
+
+struct ArithmeticSub {
+  static constexpr const char *Name = "sub";
+  static constexpr bool IsDivision = false;
+  static bool Apply(int64_t left, int64_t right, int64_t &out) {
+    out = static_cast<int64_t>(static_cast<uint64_t>(left) -
+                               static_cast<uint64_t>(right));
+    return ((left ^ right) & (left ^ out)) < 0;
+  }
+};
+
+// negation is computed as 0 - value
+struct ArithmeticNeg : ArithmeticSub {
+  static constexpr const char *Name = "neg";
+};
+
+struct ArithmeticMul {
+  static constexpr const char *Name = "mul";
+  static constexpr bool IsDivision = false;
+  static bool Apply(int64_t left, int64_t right, int64_t &out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(left, right, &out);
+#else
+    out = static_cast<int64_t>(static_cast<uint64_t>(left) *
+                               static_cast<uint64_t>(right));
+    return left == -1 ? right == std::numeric_limits<int64_t>::min()
+                      : (left != 0) && (out / left != right);
+#endif
+  }
+};
+
+// Division follows Python and rounds towards negative infinity. Rows that
+// divide by zero are null and are computed with a divisor of one instead,
+// while dividing by -1 is computed as a negation, as INT64_MIN / -1 traps
+struct ArithmeticFloorDiv {
+  static constexpr const char *Name = "floordiv";
+  static constexpr bool IsDivision = true;
+  static bool Apply(int64_t left, int64_t right, int64_t &out) {
+    const bool negate = right == -1;
+    const int64_t divisor = ((right == 0) | negate) ? 1 : right;
+    const int64_t quotient = left / divisor;
+    const int64_t remainder = left % divisor;
+    const int64_t floored =
+        quotient - ((remainder != 0) & ((remainder ^ divisor) < 0));
+    out = negate ? static_cast<int64_t>(0 - static_cast<uint64_t>(left))
+                 : floored;
+    return negate & (left == std::numeric_limits<int64_t>::min());
+  }
+};
+
+// the result takes the sign of the divisor, as in Python
+struct ArithmeticMod {
+  static constexpr const char *Name = "mod";
+  static constexpr bool IsDivision = true;
+  static bool Apply(int64_t left, int64_t right, int64_t &out) {
+    const int64_t divisor = ((right == 0) | (right == -1)) ? 1 : right;
+    const int64_t remainder = left % divisor;
+    const bool adjust = (remainder != 0) & ((remainder ^ divisor) < 0);
+    out = remainder + (divisor & -static_cast<int64_t>(adjust));
+    return false;
+  }
+};
+
+// Applies Op to left(i) and right(i) for every row. left_nulls and
+// right_nulls are the inputs with nulls to propagate, or nullptr. The data
+// loop runs over every row without branching on validity; overflow is
+// collected as a bitmap per block of 64 rows and only counts for valid rows
+template <typename Op, typename Left, typename Right>
+Int64Array ArithmeticInternal(const struct ArrowArrayView *left_nulls,
+                              const struct ArrowArrayView *right_nulls,
+                              int64_t n, Left &&left, Right &&right,
+                              bool check_overflow) {
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_INT64)) {
+    throw std::runtime_error("Unable to init int64 array!");
+  }
+
+  int64_t null_count;
+  if constexpr (Op::IsDivision) {
+    null_count = AndValidity(result.get(), left_nulls, right_nulls, n,
+                             [&](int64_t i, int64_t nbits) {
+                               return PackWord(i, nbits, [&](int64_t j) {
+                                 return right(j) != 0;
+                               });
+                             });
+  } else {
+    null_count = AndValidity(result.get(), left_nulls, right_nulls, n);
+  }
+  const uint8_t *validity = ArrowArrayValidityBitmap(result.get())->buffer.data;
+
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferResize(data, n * sizeof(int64_t), false)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+  auto out = reinterpret_cast<int64_t *>(data->data);
+
+  std::vector<uint8_t> overflowed(MorselCount(n));
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    uint64_t any = 0;
+    for (int64_t i = begin; i < end; i += 64) {
+      const int64_t nbits = std::min<int64_t>(64, end - i);
+      const uint64_t overflow = PackWord(i, nbits, [&](int64_t j) {
+        return Op::Apply(left(j), right(j), out[j]);
+      });
+      any |= validity == nullptr
+                 ? overflow
+                 : overflow & LoadBitmapWord(validity, i, nbits);
+    }
+    overflowed[begin / kMorselSize] = any != 0;
+  });
+
+  if (check_overflow &&
+      std::any_of(overflowed.begin(), overflowed.end(),
+                  [](uint8_t value) { return value != 0; })) {
+    throw std::overflow_error(std::string("int64 overflow in ") + Op::Name);
+  }
+
+  result->length = n;
+  result->null_count = null_count;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return Int64Array(std::move(result));
+}
+
+template <typename T> const struct ArrowArrayView *NullsView(const T &self) {
+  return self.GetNullCount() > 0 ? self.array_view_.get() : nullptr;
+}
+
+template <typename T> const int64_t *Int64Values(const T &self) {
+  return self.array_view_->buffer_views[1].data.as_int64 +
+         self.array_view_->offset;
+}
+
+template <typename Op, typename T>
+T Arithmetic(const T &self, const T &other, bool check_overflow) {
+  static_assert(std::is_same_v<T, Int64Array>,
+                "arithmetic is only implemented for Int64Array");
+  const auto n = self.array_view_->length;
+  if (n != other.array_view_->length) {
+    throw std::range_error("Arrays are not of equal size");
+  }
+
+  const int64_t *left = Int64Values(self);
+  const int64_t *right = Int64Values(other);
+  return ArithmeticInternal<Op>(
+      NullsView(self), NullsView(other), n,
+      [left](int64_t i) { return left[i]; },
+      [right](int64_t i) { return right[i]; }, check_overflow);
+}
+
+// self op other, with the scalar broadcast over every row
+template <typename Op, typename T>
+T ArithmeticScalar(const T &self, typename T::ScalarT other,
+                   bool check_overflow) {
+  static_assert(std::is_same_v<T, Int64Array>,
+                "arithmetic is only implemented for Int64Array");
+  const int64_t *left = Int64Values(self);
+  return ArithmeticInternal<Op>(
+      NullsView(self), nullptr, self.array_view_->length,
+      [left](int64_t i) { return left[i]; },
+      [other](int64_t) { return other; }, check_overflow);
+}
+
+// other op self, for the reflected operators like __rsub__
+template <typename Op, typename T>
+T ReflectedArithmeticScalar(const T &self, typename T::ScalarT other,
+                            bool check_overflow) {
+  static_assert(std::is_same_v<T, Int64Array>,
+                "arithmetic is only implemented for Int64Array");
+  const int64_t *right = Int64Values(self);
+  return ArithmeticInternal<Op>(
+      nullptr, NullsView(self), self.array_view_->length,
+      [other](int64_t) { return other; },
+      [right](int64_t i) { return right[i]; }, check_overflow);
+}
+
+template <typename T> T Negate(const T &self) {
+  return ReflectedArithmeticScalar<ArithmeticNeg>(self, 0, true);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+// Helpers for handling 7-bit ASCII text a word at a time. The string kernels
+// use these to skip utf8proc decoding whenever the input is plain ASCII,
+// where every codepoint is a single byte
+
+constexpr uint64_t kAsciiOnes = 0x0101010101010101ULL;
+constexpr uint64_t kAsciiHighBits = 0x8080808080808080ULL;
+
+inline bool IsAscii(const char *data, int64_t nbytes) {
+  uint64_t acc = 0;
+  int64_t i = 0;
+  for (; i + 32 <= nbytes; i += 32) {
+    uint64_t words[4];
+    std::memcpy(words, data + i, sizeof(words));
+    acc |= words[0] | words[1] | words[2] | words[3];
+    if (acc & kAsciiHighBits) {
+      return false;
+    }
+  }
+
+  for (; i + 8 <= nbytes; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    acc |= word;
+  }
+
+  if (i < nbytes) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, static_cast<size_t>(nbytes - i));
+    acc |= word;
+  }
+
+  return (acc & kAsciiHighBits) == 0;
+}
+
+// Toggles the case of every byte of an ASCII word that falls in [lo, hi].
+// Bytes with the high bit clear can have up to 0x7f added without carrying
+// into their neighbours, so the range check runs on all 8 bytes at once
+template <char Lo, char Hi> inline uint64_t AsciiToggleCaseWord(uint64_t word) {
+  const uint64_t at_least_lo = word + (0x80 - Lo) * kAsciiOnes;
+  const uint64_t above_hi = word + (0x80 - Hi - 1) * kAsciiOnes;
+  const uint64_t in_range = (at_least_lo ^ above_hi) & kAsciiHighBits;
+  return word ^ (in_range >> 2);
+}
+
+// Maps nbytes of ASCII text from src into dst, which may alias src
+template <bool ToUpper>
+inline void AsciiCaseMap(const char *src, char *dst, int64_t nbytes) {
+  constexpr char lo = ToUpper ? 'a' : 'A';
+  constexpr char hi = ToUpper ? 'z' : 'Z';
+
+  int64_t i = 0;
+  for (; i + 8 <= nbytes; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, src + i, sizeof(word));
+    word = AsciiToggleCaseWord<lo, hi>(word);
+    std::memcpy(dst + i, &word, sizeof(word));
+  }
+
+  if (i < nbytes) {
+    const auto rem = static_cast<size_t>(nbytes - i);
+    uint64_t word = 0;
+    std::memcpy(&word, src + i, rem);
+    word = AsciiToggleCaseWord<lo, hi>(word);
+    std::memcpy(dst + i, &word, rem);
+  }
+}
+
+inline char AsciiToUpper(char c) {
+  return (c >= 'a' && c <= 'z') ? static_cast<char>(c - ('a' - 'A')) : c;
+}
+
+// Character classes matching the utf8proc categories the string predicates
+// test for, restricted to ASCII. Note that only ' ' is in a Unicode space
+// separator category; control characters like '\t' are not
+enum AsciiClass : uint8_t {
+  kAsciiLower = 1 << 0,
+  kAsciiUpper = 1 << 1,
+  kAsciiDigit = 1 << 2,
+  kAsciiSpace = 1 << 3,
+};
+
+constexpr std::array<uint8_t, 128> MakeAsciiClassTable() {
+  std::array<uint8_t, 128> table{};
+  for (int c = 'a'; c <= 'z'; c++) {
+    table[c] = kAsciiLower;
+  }
+  for (int c = 'A'; c <= 'Z'; c++) {
+    table[c] = kAsciiUpper;
+  }
+  for (int c = '0'; c <= '9'; c++) {
+    table[c] = kAsciiDigit;
+  }
+  table[' '] = kAsciiSpace;
+  return table;
+}
+
+constexpr std::array<uint8_t, 128> kAsciiClassTable = MakeAsciiClassTable();
+
+// True if every byte of the ASCII text belongs to one of the given classes
+inline bool AsciiAllOf(const char *data, int64_t nbytes, uint8_t classes) {
+  for (int64_t i = 0; i < nbytes; i++) {
+    if (!(kAsciiClassTable[static_cast<uint8_t>(data[i])] & classes)) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+
+// Arrow bitmaps are LSB-first; the word-level helpers below memcpy bytes into
+// a uint64_t and therefore assume a little-endian host
+
+// Loads up to 64 bits starting at an arbitrary bit offset. Bits beyond nbits
+// are zeroed and no bytes beyond the last bit requested are read
+inline uint64_t LoadBitmapWord(const uint8_t *bitmap, int64_t bit_offset,
+                               int64_t nbits = 64) {
+  const uint8_t *src = bitmap + bit_offset / 8;
+  const int shift = static_cast<int>(bit_offset % 8);
+  const int64_t nbytes = (shift + nbits + 7) / 8;
+
+  uint64_t word = 0;
+  std::memcpy(&word, src, nbytes > 8 ? 8 : static_cast<size_t>(nbytes));
+  word >>= shift;
+  if (nbytes > 8) {
+    word |= static_cast<uint64_t>(src[8]) << (64 - shift);
+  }
+
+  if (nbits < 64) {
+    word &= (uint64_t{1} << nbits) - 1;
+  }
+
+  return word;
+}
+
+// Stores the lowest nbits of word at an arbitrary bit offset, leaving the
+// surrounding bits of the destination untouched
+inline void StoreBitmapWord(uint8_t *bitmap, int64_t bit_offset, uint64_t word,
+                            int64_t nbits = 64) {
+  uint8_t *dst = bitmap + bit_offset / 8;
+  const int shift = static_cast<int>(bit_offset % 8);
+  const int64_t nbytes = (shift + nbits + 7) / 8;
+  const uint64_t mask = nbits < 64 ? (uint64_t{1} << nbits) - 1 : ~uint64_t{0};
+  word &= mask;
+
+  const size_t head_bytes = nbytes > 8 ? 8 : static_cast<size_t>(nbytes);
+  uint64_t current = 0;
+  std::memcpy(&current, dst, head_bytes);
+  current = (current & ~(mask << shift)) | (word << shift);
+  std::memcpy(dst, &current, head_bytes);
+
+  if (nbytes > 8) {
+    const auto tail_mask = static_cast<uint8_t>(mask >> (64 - shift));
+    const auto tail = static_cast<uint8_t>(word >> (64 - shift));
+    dst[8] = static_cast<uint8_t>((dst[8] & ~tail_mask) | tail);
+  }
+}
+
+// Copies length bits between bitmaps at arbitrary bit offsets
+inline void CopyBitmap(const uint8_t *src, int64_t src_offset, uint8_t *dst,
+                       int64_t dst_offset, int64_t length) {
+  if ((src_offset % 8 == 0) && (dst_offset % 8 == 0)) {
+    const int64_t whole_bytes = length / 8;
+    std::memcpy(dst + dst_offset / 8, src + src_offset / 8, whole_bytes);
+    const int64_t rem = length % 8;
+    if (rem) {
+      StoreBitmapWord(dst, dst_offset + whole_bytes * 8,
+                      LoadBitmapWord(src, src_offset + whole_bytes * 8, rem),
+                      rem);
+    }
+    return;
+  }
+
+  int64_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    StoreBitmapWord(dst, dst_offset + i, LoadBitmapWord(src, src_offset + i));
+  }
+
+  if (i < length) {
+    StoreBitmapWord(dst, dst_offset + i,
+                    LoadBitmapWord(src, src_offset + i, length - i),
+                    length - i);
+  }
+}
+
+inline int64_t PopCount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#else
+  return static_cast<int64_t>(std::bitset<64>(word).count());
+#endif
+}
+
+// word must not be zero
+inline int CountTrailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(word);
+#else
+  int count = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    count++;
+  }
+  return count;
+#endif
+}
+
+// Packs pred(i) for i in [begin, begin + nbits) into the bits of a word. A
+// full word has a fixed trip count, which lets the compiler vectorize the
+// comparisons and the packing
+template <typename Pred>
+uint64_t PackWord(int64_t begin, int64_t nbits, Pred &&pred) {
+  uint64_t word = 0;
+  if (nbits == 64) {
+    for (int64_t j = 0; j < 64; j++) {
+      word |= static_cast<uint64_t>(pred(begin + j)) << j;
+    }
+  } else {
+    for (int64_t j = 0; j < nbits; j++) {
+      word |= static_cast<uint64_t>(pred(begin + j)) << j;
+    }
+  }
+
+  return word;
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nanoarrow/nanoarrow.hpp>
+#include <utf8proc.h>
+
+#include "../array_types.hpp"
+#include "bitmap.hpp"
+#include "parallel.hpp"
+
+// Builds a StringArray holding one transformed string per row of a source
+// array, as needed by the case mapping kernels. Validity is copied from the
+// source up front. Like BuildStringBuffers, every row is produced twice: a
+// parallel sizing pass only counts bytes, so the data buffer is allocated
+// once at its final size, and a second pass writes each morsel straight into
+// its place in that buffer with no per-row allocations. row_func must
+// therefore produce the same bytes both times it is called for a row
+class StringTransformBuilder {
+public:
+  // Appends to the rows of a single morsel, or only counts the bytes that
+  // would be appended during the sizing pass
+  class RowWriter {
+  public:
+    // Returns space for exactly nbytes at the end of the current row, or
+    // nullptr during the sizing pass, when there is nothing to write
+    char *Extend(int64_t nbytes) {
+      size_ += nbytes;
+      if (out_ == nullptr) {
+        return nullptr;
+      }
+      char *out = out_;
+      out_ += nbytes;
+      return out;
+    }
+
+    void AppendCodepoint(utf8proc_int32_t codepoint) {
+      utf8proc_uint8_t scratch[4];
+      auto dst = out_ != nullptr ? reinterpret_cast<utf8proc_uint8_t *>(out_)
+                                 : scratch;
+      const auto nbytes = utf8proc_encode_char(codepoint, dst);
+      size_ += nbytes;
+      if (out_ != nullptr) {
+        out_ += nbytes;
+      }
+    }
+
+  private:
+    friend class StringTransformBuilder;
+
+    explicit RowWriter(char *out) : out_(out) {}
+
+    char *out_;
+    int64_t size_ = 0;
+  };
+
+  explicit StringTransformBuilder(const StringArray &source) {
+    const struct ArrowArrayView *array_view = source.array_view_.get();
+    length_ = array_view->length;
+    null_count_ = source.GetNullCount();
+
+    if (ArrowArrayInitFromType(array_.get(), NANOARROW_TYPE_LARGE_STRING)) {
+      throw std::runtime_error("Unable to init large string array!");
+    }
+
+    if (null_count_ > 0) {
+      struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(array_.get());
+      if (ArrowBufferAppendFill(&bitmap->buffer, 0,
+                                _ArrowBytesForBits(length_))) {
+        throw std::runtime_error("Unable to allocate validity bitmap!");
+      }
+      CopyBitmap(array_view->buffer_views[0].data.as_uint8, array_view->offset,
+                 bitmap->buffer.data, 0, length_);
+      bitmap->size_bits = length_;
+    }
+  }
+
+  // Calls row_func(writer, i) twice for every row i, null rows included,
+  // which should write nothing for them
+  template <typename RowFunc> StringArray Build(RowFunc &&row_func) {
+    struct ArrowBuffer *offsets = ArrowArrayBuffer(array_.get(), 1);
+    if (ArrowBufferResize(offsets, (length_ + 1) * sizeof(int64_t), false)) {
+      throw std::runtime_error("Unable to allocate offsets buffer!");
+    }
+    auto out_offsets = reinterpret_cast<int64_t *>(offsets->data);
+    out_offsets[0] = 0;
+
+    // offsets start out relative to the morsel that measured them
+    std::vector<int64_t> starts(MorselCount(length_) + 1, 0);
+    ParallelFor(length_, [&](int64_t begin, int64_t end) {
+      RowWriter writer{nullptr};
+      for (int64_t i = begin; i < end; i++) {
+        row_func(writer, i);
+        out_offsets[i + 1] = writer.size_;
+      }
+      starts[begin / kMorselSize + 1] = writer.size_;
+    });
+    for (size_t morsel = 1; morsel < starts.size(); morsel++) {
+      starts[morsel] += starts[morsel - 1];
+    }
+
+    struct ArrowBuffer *data = ArrowArrayBuffer(array_.get(), 2);
+    if (ArrowBufferResize(data, starts.back(), false)) {
+      throw std::runtime_error("Unable to allocate data buffer!");
+    }
+
+    auto dst = reinterpret_cast<char *>(data->data);
+    ParallelFor(length_, [&](int64_t begin, int64_t end) {
+      const int64_t start = starts[begin / kMorselSize];
+      RowWriter writer{dst + start};
+      for (int64_t i = begin; i < end; i++) {
+        out_offsets[i + 1] += start;
+        row_func(writer, i);
+      }
+    });
+
+    array_->length = length_;
+    array_->null_count = null_count_;
+
+    struct ArrowError error;
+    if (ArrowArrayFinishBuildingDefault(array_.get(), &error)) {
+      throw std::runtime_error("Failed to finish building: " +
+                               std::string(error.message));
+    }
+
+    return StringArray{std::move(array_)};
+  }
+
+private:
+  nanoarrow::UniqueArray array_;
+  int64_t length_;
+  int64_t null_count_;
+};
+
+// Fills in the offsets and data buffers of a freshly initialized string
+// array with n rows, each given as a view by row_func(i); null rows should be
+// returned as empty views. The first pass only accumulates offsets, so the
+// data buffer is allocated exactly once at its final size and the second
+// pass can copy every row independently of the others
+template <typename RowFunc>
+void BuildStringBuffers(struct ArrowArray *array, int64_t n,
+                        RowFunc &&row_func) {
+  struct ArrowBuffer *offsets = ArrowArrayBuffer(array, 1);
+  if (ArrowBufferResize(offsets, (n + 1) * sizeof(int64_t), false)) {
+    throw std::runtime_error("Unable to allocate offsets buffer!");
+  }
+  auto out_offsets = reinterpret_cast<int64_t *>(offsets->data);
+  out_offsets[0] = 0;
+  for (int64_t i = 0; i < n; i++) {
+    out_offsets[i + 1] =
+        out_offsets[i] + static_cast<int64_t>(row_func(i).size());
+  }
+
+  struct ArrowBuffer *data = ArrowArrayBuffer(array, 2);
+  if (ArrowBufferResize(data, out_offsets[n], false)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const std::string_view row = row_func(i);
+      if (!row.empty()) {
+        std::memcpy(data->data + out_offsets[i], row.data(), row.size());
+      }
+    }
+  });
+}
@@ -0,0 +1,563 @@
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nanobind/nanobind.h>
+
+#include "../chunked_array.hpp"
+#include "arithmetic.hpp"
+#include "compare.hpp"
+#include "generic.hpp"
+#include "logical.hpp"
+#include "numeric.hpp"
+#include "numpy_.hpp"
+#include "sort.hpp"
+
+namespace nb = nanobind;
+
+// Applies a kernel to every chunk, collecting the results as the chunks of a
+// new ChunkedArray
+template <typename T, typename Func>
+auto MapChunks(const ChunkedArray<T> &self, Func &&func) {
+  using R = std::decay_t<decltype(func(std::declval<const T &>()))>;
+  std::vector<R> chunks;
+  chunks.reserve(self.chunks().size());
+  for (const auto &chunk : self.chunks()) {
+    chunks.push_back(func(chunk));
+  }
+
+  return ChunkedArray<R>(std::move(chunks));
+}
+
+// Binds an element-wise kernel of T so that it runs chunk by chunk, e.g.
+// &ChunkWise<&Lower, StringArray> or &ChunkWise<&FillNA<T>, T, ScalarT>
+template <auto Kernel, typename T, typename... Args>
+auto ChunkWise(const ChunkedArray<T> &self, Args... args) {
+  return MapChunks(self,
+                   [&](const T &chunk) { return Kernel(chunk, args...); });
+}
+
+template <typename T> ChunkedArray<T> SingleChunk(T &&array) {
+  std::vector<T> chunks;
+  chunks.push_back(std::move(array));
+  return ChunkedArray<T>(std::move(chunks));
+}
+
+// Shares rows [begin, end) of self as a list of chunks, narrowing the first
+// and last chunks that overlap the range and sharing the ones in between
+// untouched
+template <typename T>
+std::vector<T> ShareRange(const ChunkedArray<T> &self, int64_t begin,
+                          int64_t end) {
+  std::vector<T> chunks;
+  const auto &starts = self.chunk_starts();
+  for (size_t c = 0; c < self.chunks().size(); c++) {
+    const int64_t lo = std::max(begin, starts[c]);
+    const int64_t hi = std::min(end, starts[c + 1]);
+    if (lo < hi) {
+      chunks.push_back(ChunkedArray<T>::ShareChunk(self.chunks()[c],
+                                                   lo - starts[c], hi - lo));
+    }
+  }
+  return chunks;
+}
+
+template <typename T> T CombineChunks(const ChunkedArray<T> &self) {
+  if (self.chunks().size() == 1) {
+    return ChunkedArray<T>::ShareChunk(self.chunks().front());
+  }
+
+  std::vector<const T *> chunks;
+  chunks.reserve(self.chunks().size());
+  for (const auto &chunk : self.chunks()) {
+    chunks.push_back(&chunk);
+  }
+
+  return Concatenate(chunks);
+}
+
+// Splits other at the chunk boundaries of self, so that binary kernels and
+// masks can run chunk by chunk. Rows are only copied for the chunks of self
+// that span a chunk boundary of other
+template <typename T, typename U>
+std::vector<U> AlignChunks(const ChunkedArray<T> &self,
+                           const ChunkedArray<U> &other) {
+  if (self.length() != other.length()) {
+    throw std::range_error("Arrays are not of equal size");
+  }
+
+  std::vector<U> aligned;
+  aligned.reserve(self.chunks().size());
+  const auto &starts = self.chunk_starts();
+  for (size_t c = 0; c < self.chunks().size(); c++) {
+    auto pieces = ShareRange(other, starts[c], starts[c + 1]);
+    if (pieces.size() == 1) {
+      aligned.push_back(std::move(pieces.front()));
+    } else {
+      aligned.push_back(CombineChunks(ChunkedArray<U>(std::move(pieces))));
+    }
+  }
+  return aligned;
+}
+
+template <typename T, typename U>
+std::vector<U> AlignChunks(const ChunkedArray<T> &self, const U &other) {
+  if (self.length() != other.array_view_->length) {
+    throw std::range_error("Arrays are not of equal size");
+  }
+
+  std::vector<U> aligned;
+  aligned.reserve(self.chunks().size());
+  const auto &starts = self.chunk_starts();
+  for (size_t c = 0; c < self.chunks().size(); c++) {
+    aligned.push_back(ChunkedArray<U>::ShareChunk(other, starts[c],
+                                                  starts[c + 1] - starts[c]));
+  }
+  return aligned;
+}
+
+// Filters each chunk by the matching rows of a plain or chunked mask, so
+// the result stays chunked and no chunk is combined with another
+template <typename T, typename Mask>
+ChunkedArray<T> ChunkedFilter(const ChunkedArray<T> &self, const Mask &mask) {
+  int64_t mask_length;
+  if constexpr (std::is_same_v<Mask, BoolArray>) {
+    mask_length = mask.array_view_->length;
+  } else {
+    mask_length = mask.length();
+  }
+  if (mask_length != self.length()) {
+    throw std::out_of_range("boolean index has wrong length");
+  }
+
+  const auto aligned = AlignChunks(self, mask);
+  std::vector<T> chunks;
+  chunks.reserve(self.chunks().size());
+  for (size_t c = 0; c < self.chunks().size(); c++) {
+    chunks.push_back(FilterByMask(self.chunks()[c], aligned[c]));
+  }
+  return ChunkedArray<T>(std::move(chunks));
+}
+
+// Applies a binary kernel to the chunks of self and the matching rows of
+// other, which is either a chunked or a plain array of the same type. The
+// kernels below take a chunked other unless told otherwise, e.g.
+// &ChunkedCompare<CompareEq, T, T> compares with a plain array
+template <typename T, typename Other, typename Func>
+auto ZipChunks(const ChunkedArray<T> &self, const Other &other, Func &&func) {
+  const auto aligned = AlignChunks(self, other);
+  using R = std::decay_t<decltype(func(std::declval<const T &>(),
+                                       std::declval<const T &>()))>;
+  std::vector<R> chunks;
+  chunks.reserve(self.chunks().size());
+  for (size_t c = 0; c < self.chunks().size(); c++) {
+    chunks.push_back(func(self.chunks()[c], aligned[c]));
+  }
+
+  return ChunkedArray<R>(std::move(chunks));
+}
+
+template <typename Op, typename T, typename Other = ChunkedArray<T>>
+ChunkedArray<BoolArray> ChunkedCompare(const ChunkedArray<T> &self,
+                                       const Other &other) {
+  return ZipChunks(self, other, [](const T &left, const T &right) {
+    return Compare<Op, T>(left, right);
+  });
+}
+
+template <typename Op, typename T>
+ChunkedArray<BoolArray> ChunkedCompareScalar(const ChunkedArray<T> &self,
+                                             typename T::ScalarT other) {
+  return ChunkWise<&CompareScalar<Op, T>, T, typename T::ScalarT>(self, other);
+}
+
+template <typename Op, typename T, typename Other = ChunkedArray<T>>
+ChunkedArray<T> ChunkedLogical(const ChunkedArray<T> &self,
+                               const Other &other) {
+  return ZipChunks(self, other, [](const T &left, const T &right) {
+    return Logical<Op, T>(left, right);
+  });
+}
+
+template <typename Op, typename T>
+ChunkedArray<T> ChunkedLogicalScalar(const ChunkedArray<T> &self,
+                                     std::optional<bool> other) {
+  return ChunkWise<&LogicalScalar<Op, T>, T, std::optional<bool>>(self, other);
+}
+
+template <typename Op, typename T, typename Other = ChunkedArray<T>>
+ChunkedArray<T> ChunkedArithmetic(const ChunkedArray<T> &self,
+                                  const Other &other, bool check_overflow) {
+  return ZipChunks(self, other,
+                   [check_overflow](const T &left, const T &right) {
+                     return Arithmetic<Op, T>(left, right, check_overflow);
+                   });
+}
+
+template <typename Op, typename T>
+ChunkedArray<T> ChunkedArithmeticScalar(const ChunkedArray<T> &self,
+                                        typename T::ScalarT other,
+                                        bool check_overflow) {
+  return ChunkWise<&ArithmeticScalar<Op, T>, T, typename T::ScalarT, bool>(
+      self, other, check_overflow);
+}
+
+template <typename Op, typename T>
+ChunkedArray<T>
+ChunkedReflectedArithmeticScalar(const ChunkedArray<T> &self,
+                                 typename T::ScalarT other,
+                                 bool check_overflow) {
+  return ChunkWise<&ReflectedArithmeticScalar<Op, T>, T, typename T::ScalarT,
+                   bool>(self, other, check_overflow);
+}
+
+template <typename T>
+ChunkedArray<T> ChunkedFromChunks(const std::vector<const T *> &chunks) {
+  return ChunkedArray<T>(chunks);
+}
+
+template <typename T> int64_t ChunkedLenDunder(const ChunkedArray<T> &self) {
+  return self.length();
+}
+
+template <typename T> int64_t NumChunks(const ChunkedArray<T> &self) {
+  return static_cast<int64_t>(self.chunks().size());
+}
+
+template <typename T>
+ExtensionDtype<T> ChunkedDtype([[maybe_unused]] const ChunkedArray<T> &self) {
+  return ExtensionDtype<T>{};
+}
+
+template <typename T> int64_t ChunkedNullCount(const ChunkedArray<T> &self) {
+  int64_t null_count = 0;
+  for (const auto &chunk : self.chunks()) {
+    null_count += chunk.GetNullCount();
+  }
+  return null_count;
+}
+
+// Returns new references to the chunks rather than the chunks themselves,
+// which Python could otherwise keep alive independently of self
+template <typename T> std::vector<T> Chunks(const ChunkedArray<T> &self) {
+  std::vector<T> chunks;
+  chunks.reserve(self.chunks().size());
+  for (const auto &chunk : self.chunks()) {
+    chunks.push_back(ChunkedArray<T>::ShareChunk(chunk));
+  }
+  return chunks;
+}
+
+template <typename T>
+auto ChunkedGetItemDunder(const ChunkedArray<T> &self, nb::object indexer)
+    -> nb::object {
+  const int64_t n = self.length();
+
+  int64_t i;
+  if (nb::try_cast(indexer, i, false)) {
+    if ((i >= n) || (i < -n)) {
+      throw std::out_of_range("index out of bounds");
+    }
+    const auto [chunk, index] = self.Locate(i >= 0 ? i : i + n);
+    return GetItemDunder(self.chunks()[chunk], nb::int_(index));
+  }
+
+  nb::slice sliceobj;
+  if (nb::try_cast(indexer, sliceobj, false)) {
+    const auto [start, _, step, slice_length] = sliceobj.compute(n);
+    if (step == 1) {
+      const auto begin = static_cast<int64_t>(start);
+      return nb::cast(ChunkedArray<T>(ShareRange(
+          self, begin, begin + static_cast<int64_t>(slice_length))));
+    }
+  }
+
+  // masks filter chunk by chunk, so the result stays chunked
+  const auto filter = [&self](const auto &mask) {
+    auto result = [&] {
+      nb::gil_scoped_release release;
+      return ChunkedFilter(self, mask);
+    }();
+    return nb::cast(std::move(result));
+  };
+  if (nb::isinstance<BoolArray>(indexer)) {
+    return filter(nb::cast<const BoolArray &>(indexer));
+  }
+  if (nb::isinstance<ChunkedArray<BoolArray>>(indexer)) {
+    return filter(nb::cast<const ChunkedArray<BoolArray> &>(indexer));
+  }
+  nb::ndarray<const bool, nb::ndim<1>> array;
+  if (nb::try_cast(indexer, array, false)) {
+    return filter(FromNumpy<BoolArray>(indexer, nb::none()));
+  }
+
+  // lists of positions and strided slices gather rows from all the chunks,
+  // so they index the combined chunks instead
+  nb::object result = GetItemDunder(CombineChunks(self), indexer);
+  if (nb::isinstance<T>(result)) {
+    return nb::cast(
+        SingleChunk(ChunkedArray<T>::ShareChunk(nb::cast<const T &>(result))));
+  }
+  return result;
+}
+
+// Chunks share one cache, so values repeated across chunks share a str too
+template <typename T> nb::list ChunkedToPyList(const ChunkedArray<T> &self) {
+  PyObject *list = PyList_New(self.length());
+  if (list == nullptr) {
+    throw nb::python_error();
+  }
+  auto result = nb::steal<nb::list>(list);
+
+  PyStrCache cache;
+  for (size_t c = 0; c < self.chunks().size(); c++) {
+    FillPyList(self.chunks()[c], list, self.chunk_starts()[c], cache);
+  }
+
+  return result;
+}
+
+// Bound like ConcatSameType, so both arr._concat_same_type(other) and the
+// classmethod style call pandas makes, cls._concat_same_type(to_concat),
+// work. Any mix of chunked and plain arrays is accepted, and only their
+// chunk references are copied, so no data is touched
+template <typename T>
+ChunkedArray<T> ChunkedConcatSameType(nb::handle self, nb::handle to_concat) {
+  // holds the arrays until their chunks have been shared, as iterating may
+  // hand out the only reference to them
+  nb::list arrays;
+  const auto append = [&arrays](nb::handle obj) {
+    if (nb::isinstance<ChunkedArray<T>>(obj) || nb::isinstance<T>(obj)) {
+      arrays.append(obj);
+      return;
+    }
+    for (nb::handle item : nb::iter(obj)) {
+      if (!nb::isinstance<ChunkedArray<T>>(item) && !nb::isinstance<T>(item)) {
+        const auto message = std::string("cannot concatenate ") +
+                             nb::type_name(item.type()).c_str() + " with " +
+                             T::Name;
+        throw nb::type_error(message.c_str());
+      }
+      arrays.append(item);
+    }
+  };
+
+  append(self);
+  if (!to_concat.is_none()) {
+    append(to_concat);
+  }
+
+  std::vector<const T *> chunks;
+  for (nb::handle array : arrays) {
+    if (nb::isinstance<T>(array)) {
+      chunks.push_back(&nb::cast<const T &>(array));
+      continue;
+    }
+    const auto &chunked = nb::cast<const ChunkedArray<T> &>(array);
+    for (const auto &chunk : chunked.chunks()) {
+      chunks.push_back(&chunk);
+    }
+  }
+
+  nb::gil_scoped_release release;
+  return ChunkedArray<T>(chunks);
+}
+
+template <typename T>
+std::optional<typename T::ScalarT>
+ChunkedSum(const ChunkedArray<T> &self, bool skipna, int64_t min_count) {
+  const auto n = self.length();
+  const auto null_count = ChunkedNullCount(self);
+  if ((!skipna && null_count > 0) || (n - null_count < min_count)) {
+    return std::nullopt;
+  }
+
+  // overflow is only checked once all the chunks have been added, as
+  // partial sums may leave the int64 range and come back
+  CheckedInt64Sum total;
+  for (const auto &chunk : self.chunks()) {
+    total.Merge(SumInternal(chunk));
+  }
+
+  if (!total.Fits()) {
+    throw std::overflow_error("int64 overflow in sum");
+  }
+
+  return static_cast<int64_t>(total.lo);
+}
+
+template <typename T, bool IsMin>
+std::optional<typename T::ScalarT>
+ChunkedMinMaxInternal(const ChunkedArray<T> &self, bool skipna) {
+  if (!skipna && ChunkedNullCount(self) > 0) {
+    return std::nullopt;
+  }
+
+  std::optional<typename T::ScalarT> result;
+  for (const auto &chunk : self.chunks()) {
+    const auto value = MinMaxInternal<T, IsMin>(chunk, true);
+    if (value && (!result || (IsMin ? *value < *result : *value > *result))) {
+      result = value;
+    }
+  }
+
+  return result;
+}
+
+template <typename T>
+std::optional<typename T::ScalarT> ChunkedMin(const ChunkedArray<T> &self,
+                                              bool skipna) {
+  return ChunkedMinMaxInternal<T, true>(self, skipna);
+}
+
+template <typename T>
+std::optional<typename T::ScalarT> ChunkedMax(const ChunkedArray<T> &self,
+                                              bool skipna) {
+  return ChunkedMinMaxInternal<T, false>(self, skipna);
+}
+
+template <typename T> int64_t ChunkedNbytes(const ChunkedArray<T> &self) {
+  int64_t nbytes = 0;
+  for (const auto &chunk : self.chunks()) {
+    nbytes += Nbytes(chunk);
+  }
+  return nbytes;
+}
+
+template <typename T>
+std::tuple<int64_t> ChunkedShape(const ChunkedArray<T> &self) {
+  return self.length();
+}
+
+template <typename T> bool ChunkedAny(const ChunkedArray<T> &self) {
+  return self.length() > ChunkedNullCount(self);
+}
+
+template <typename T> bool ChunkedAll(const ChunkedArray<T> &self) {
+  return ChunkedNullCount(self) == 0;
+}
+
+template <typename T>
+std::string ChunkedReprDunder(const ChunkedArray<T> &self) {
+  return "Chunked" + ReprDunder(CombineChunks(self));
+}
+
+/*
+ * The kernels below need the rows of all the chunks at once, so they run on
+ * the combined chunks, which only copies data when there is more than one.
+ * Arrays of type T are returned as a single chunk, so that pandas gets the
+ * type it called the method on back
+ */
+template <typename T>
+ChunkedArray<T> ChunkedTake(const ChunkedArray<T> &self, nb::handle indices,
+                            bool allow_fill, nb::object fill_value) {
+  const T combined = [&self] {
+    nb::gil_scoped_release release;
+    return CombineChunks(self);
+  }();
+  return SingleChunk(Take(combined, indices, allow_fill, fill_value));
+}
+
+template <typename T>
+ChunkedArray<T> ChunkedUnique(const ChunkedArray<T> &self, bool sort) {
+  return SingleChunk(Unique(CombineChunks(self), sort));
+}
+
+template <typename T>
+std::tuple<Int64Array, ChunkedArray<T>>
+ChunkedFactorize(const ChunkedArray<T> &self,
+                 std::optional<int64_t> size_hint) {
+  auto [codes, uniques] = Factorize(CombineChunks(self), size_hint);
+  return std::make_tuple(std::move(codes), SingleChunk(std::move(uniques)));
+}
+
+template <typename T>
+Int64Array ChunkedArgSort(const ChunkedArray<T> &self, bool ascending,
+                          const std::string &na_position) {
+  return ArgSort(CombineChunks(self), ascending, na_position);
+}
+
+template <typename T>
+ChunkedArray<T> ChunkedSort(const ChunkedArray<T> &self, bool ascending,
+                            const std::string &na_position) {
+  return SingleChunk(Sort(CombineChunks(self), ascending, na_position));
+}
+
+template <typename T>
+std::tuple<ChunkedArray<T>, Int64Array>
+ChunkedTopK(const ChunkedArray<T> &self, int64_t k, bool largest) {
+  auto [values, positions] = TopK(CombineChunks(self), k, largest);
+  return std::make_tuple(SingleChunk(std::move(values)), std::move(positions));
+}
+
+template <typename T>
+ChunkedArray<T> ChunkedPadOrBackfill(const ChunkedArray<T> &self,
+                                     std::string_view method) {
+  return SingleChunk(PadOrBackfill(CombineChunks(self), method));
+}
+
+template <typename T>
+ChunkedArray<T> ChunkedInterpolate(const ChunkedArray<T> &self) {
+  return SingleChunk(Interpolate(CombineChunks(self)));
+}
+
+template <typename T>
+ChunkedArray<T>
+ChunkedFromSequence([[maybe_unused]] const ChunkedArray<T> &self,
+                    nb::handle sequence) {
+  return SingleChunk(FromPySequence<T>(sequence));
+}
+
+template <typename T>
+ChunkedArray<T>
+ChunkedFromFactorized([[maybe_unused]] const ChunkedArray<T> &self,
+                      const Int64Array &locs, const ChunkedArray<T> &values) {
+  const T combined = CombineChunks(values);
+  return SingleChunk(FromFactorized(combined, locs, combined));
+}
+
+template <typename T> ChunkedArray<T> ChunkedFromArrow(nb::object obj) {
+  return SingleChunk(FromArrow<T>(obj));
+}
+
+template <typename T>
+nb::capsule ChunkedArrowCSchema([[maybe_unused]] const ChunkedArray<T> &self) {
+  return SchemaCapsule<T>();
+}
+
+// A single chunk is exported without a copy
+template <typename T>
+std::tuple<nb::capsule, nb::capsule>
+ChunkedArrowCArray(const ChunkedArray<T> &self, nb::object requested_schema) {
+  return ArrowCArray(CombineChunks(self), requested_schema);
+}
+
+template <typename T>
+nb::object ChunkedToNumpy(const ChunkedArray<T> &self, nb::handle dtype,
+                          bool copy, nb::handle na_value) {
+  return ToNumpy(CombineChunks(self), dtype, copy, na_value);
+}
+
+template <typename T>
+std::tuple<nb::object, nb::object>
+ChunkedToNumpyMasked(const ChunkedArray<T> &self) {
+  return ToNumpyMasked(CombineChunks(self));
+}
+
+template <typename T>
+nb::object ChunkedArrayDunder(const ChunkedArray<T> &self, nb::handle dtype,
+                              std::optional<bool> copy) {
+  // more than one chunk must be copied into a contiguous buffer
+  if (copy == false && self.chunks().size() > 1) {
+    throw std::invalid_argument(std::string("unable to avoid a copy while "
+                                            "converting a chunked ") +
+                                T::Name + " to numpy");
+  }
+  return ArrayDunder(CombineChunks(self), dtype, copy);
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../array_types.hpp"
+#include "bitmap.hpp"
+#include "parallel.hpp"
+
+// Comparison operators. Apply compares two int64 or string values, while
+// ApplyWords compares 64 packed booleans at once, with false < true. Strings
+// are ordered by their bytes, which matches the code point order of Python
+struct CompareEq {
+  template <typename V> static bool Apply(const V &left, const V &right) {
+    return left == right;
+  }
+  static uint64_t ApplyWords(uint64_t left, uint64_t right) {
+    return ~(left ^ right);
+  }
+};
+
+struct CompareNe {
+  template <typename V> static bool Apply(const V &left, const V &right) {
+    return left != right;
+  }
+  static uint64_t ApplyWords(uint64_t left, uint64_t right) {
+    return left ^ right;
+  }
+};
+
+struct CompareLt {
+  template <typename V> static bool Apply(const V &left, const V &right) {
+    return left < right;
+  }
+  static uint64_t ApplyWords(uint64_t left, uint64_t right) {
+    return ~left & right;
+  }
+};
+
+struct CompareLe {
+  template <typename V> static bool Apply(const V &left, const V &right) {
+    return left <= right;
+  }
+  static uint64_t ApplyWords(uint64_t left, uint64_t right) {
+    return ~left | right;
+  }
+};
+
+struct CompareGt {
+  template <typename V> static bool Apply(const V &left, const V &right) {
+    return left > right;
+  }
+  static uint64_t ApplyWords(uint64_t left, uint64_t right) {
+    return left & ~right;
+  }
+};
+
+struct CompareGe {
+  template <typename V> static bool Apply(const V &left, const V &right) {
+    return left >= right;
+  }
+  static uint64_t ApplyWords(uint64_t left, uint64_t right) {
+    return left | ~right;
+  }
+};
+
+// Fills a bitmap of n bits starting at bit 0 with word_func(i, nbits), which
+// returns the bits for positions [i, i + nbits). Morsels are aligned with
+// the words, so they never share one
+template <typename WordFunc>
+void FillBitmapWords(uint8_t *out, int64_t n, WordFunc &&word_func) {
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i += 64) {
+      const int64_t nbits = std::min<int64_t>(64, end - i);
+      uint64_t word = word_func(i, nbits);
+      if (nbits < 64) {
+        word &= (uint64_t{1} << nbits) - 1;
+      }
+      std::memcpy(out + i / 8, &word, static_cast<size_t>((nbits + 7) / 8));
+    }
+  });
+}
+
+// Sets the validity of a result to the word-wise AND of the validity of its
+// inputs and of mask_func(i, nbits), which returns further bits to clear for
+// positions [i, i + nbits), and returns the resulting null count. Inputs
+// without nulls are passed as nullptr
+template <typename MaskFunc>
+int64_t AndValidity(struct ArrowArray *result,
+                    const struct ArrowArrayView *left,
+                    const struct ArrowArrayView *right, int64_t n,
+                    MaskFunc &&mask_func) {
+  struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result);
+  if (ArrowBufferResize(&bitmap->buffer, _ArrowBytesForBits(n), false)) {
+    throw std::runtime_error("Unable to allocate validity bitmap!");
+  }
+  bitmap->size_bits = n;
+
+  const auto load = [](const struct ArrowArrayView *view, int64_t i,
+                       int64_t nbits) {
+    return view == nullptr ? ~uint64_t{0}
+                           : LoadBitmapWord(view->buffer_views[0].data.as_uint8,
+                                            view->offset + i, nbits);
+  };
+
+  std::vector<int64_t> valid_counts(MorselCount(n));
+  FillBitmapWords(bitmap->buffer.data, n, [&](int64_t i, int64_t nbits) {
+    uint64_t word =
+        load(left, i, nbits) & load(right, i, nbits) & mask_func(i, nbits);
+    if (nbits < 64) {
+      word &= (uint64_t{1} << nbits) - 1;
+    }
+    valid_counts[i / kMorselSize] += PopCount(word);
+    return word;
+  });
+
+  int64_t null_count = n;
+  for (const auto count : valid_counts) {
+    null_count -= count;
+  }
+
+  return null_count;
+}
+
+// Same as above without a mask; no bitmap is allocated when neither input
+// has nulls
+inline int64_t AndValidity(struct ArrowArray *result,
+                           const struct ArrowArrayView *left,
+                           const struct ArrowArrayView *right, int64_t n) {
+  if ((left == nullptr) && (right == nullptr)) {
+    return 0;
+  }
+
+  return AndValidity(result, left, right, n,
+                     [](int64_t, int64_t) { return ~uint64_t{0}; });
+}
+
+// Compares self against either another array of the same length or a
+// scalar, in which case right_array is nullptr and every row is compared
+// against right_scalar. Rows where either side is null are null
+template <typename Op, typename T>
+BoolArray CompareInternal(const T &self, const T *right_array,
+                          const typename T::ScalarT &right_scalar) {
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_BOOL)) {
+    throw std::runtime_error("Unable to init bool array!");
+  }
+
+  const struct ArrowArrayView *left = self.array_view_.get();
+  const struct ArrowArrayView *right =
+      right_array != nullptr ? right_array->array_view_.get() : nullptr;
+  const auto n = left->length;
+  if ((right != nullptr) && (n != right->length)) {
+    throw std::range_error("Arrays are not of equal size");
+  }
+
+  const bool right_has_nulls =
+      (right_array != nullptr) && (right_array->GetNullCount() > 0);
+  const auto null_count =
+      AndValidity(result.get(), self.GetNullCount() > 0 ? left : nullptr,
+                  right_has_nulls ? right : nullptr, n);
+
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferResize(data, _ArrowBytesForBits(n), false)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+
+  // null rows are compared like any other, as the validity masks them out
+  if constexpr (std::is_same_v<T, BoolArray>) {
+    const uint8_t *left_bits = left->buffer_views[1].data.as_uint8;
+    const uint64_t scalar_word = right_scalar ? ~uint64_t{0} : 0;
+    FillBitmapWords(data->data, n, [&](int64_t i, int64_t nbits) {
+      const uint64_t left_word =
+          LoadBitmapWord(left_bits, left->offset + i, nbits);
+      const uint64_t right_word =
+          right == nullptr
+              ? scalar_word
+              : LoadBitmapWord(right->buffer_views[1].data.as_uint8,
+                               right->offset + i, nbits);
+      return Op::ApplyWords(left_word, right_word);
+    });
+  } else if constexpr (std::is_same_v<T, Int64Array>) {
+    const int64_t *left_values =
+        left->buffer_views[1].data.as_int64 + left->offset;
+    if (right == nullptr) {
+      const int64_t value = right_scalar;
+      FillBitmapWords(data->data, n, [&](int64_t i, int64_t nbits) {
+        return PackWord(i, nbits, [&](int64_t j) {
+          return Op::Apply(left_values[j], value);
+        });
+      });
+    } else {
+      const int64_t *right_values =
+          right->buffer_views[1].data.as_int64 + right->offset;
+      FillBitmapWords(data->data, n, [&](int64_t i, int64_t nbits) {
+        return PackWord(i, nbits, [&](int64_t j) {
+          return Op::Apply(left_values[j], right_values[j]);
+        });
+      });
+    }
+  } else if constexpr (std::is_same_v<T, StringArray>) {
+    // equality of string_views checks the lengths taken from the offsets
+    // before calling memcmp, so most unequal strings never touch their data.
+    // Ordering compares the common prefix with memcmp, then the lengths
+    const auto row = [](const struct ArrowArrayView *view, int64_t i) {
+      const int64_t *offsets = view->buffer_views[1].data.as_int64;
+      const int64_t start = offsets[view->offset + i];
+      return std::string_view(view->buffer_views[2].data.as_char + start,
+                              offsets[view->offset + i + 1] - start);
+    };
+
+    FillBitmapWords(data->data, n, [&](int64_t i, int64_t nbits) {
+      if (right == nullptr) {
+        return PackWord(i, nbits, [&](int64_t j) {
+          return Op::Apply(row(left, j), right_scalar);
+        });
+      }
+      return PackWord(i, nbits, [&](int64_t j) {
+        return Op::Apply(row(left, j), row(right, j));
+      });
+    });
+  } else {
+    // see https://stackoverflow.com/a/64354296/621736
+    static_assert(!sizeof(T), "comparison not implemented for type");
+  }
+
+  result->length = n;
+  result->null_count = null_count;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return BoolArray(std::move(result));
+}
+
+template <typename Op, typename T>
+BoolArray Compare(const T &self, const T &other) {
+  return CompareInternal<Op, T>(self, &other, typename T::ScalarT{});
+}
+
+template <typename Op, typename T>
+BoolArray CompareScalar(const T &self, typename T::ScalarT other) {
+  return CompareInternal<Op, T>(self, nullptr, other);
+}
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nanobind/nanobind.h>
+
+#include "../dictionary_array.hpp"
+#include "bitmap.hpp"
+#include "compare.hpp"
+#include "generic.hpp"
+#include "parallel.hpp"
+#include "pyobjects.hpp"
+
+namespace nb = nanobind;
+
+// Builds dictionary codes from int64 codes where -1 or a null marks a
+// missing row, checking that every other code, including any other negative
+// one, points into a dictionary of dictionary_length values
+inline nanoarrow::UniqueArray
+NarrowCodes(const struct ArrowArrayView *codes_nulls, const int64_t *codes,
+            int64_t n, int64_t dictionary_length) {
+  if (dictionary_length > std::numeric_limits<int32_t>::max()) {
+    throw std::overflow_error("dictionary is too large for int32 codes");
+  }
+
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_INT32)) {
+    throw std::runtime_error("Unable to init int32 array!");
+  }
+
+  const int64_t null_count = AndValidity(
+      result.get(), codes_nulls, nullptr, n, [codes](int64_t i, int64_t nbits) {
+        return PackWord(i, nbits,
+                        [codes](int64_t j) { return codes[j] != -1; });
+      });
+  const uint8_t *validity = ArrowArrayValidityBitmap(result.get())->buffer.data;
+
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferResize(data, n * sizeof(int32_t), false)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+  auto out = reinterpret_cast<int32_t *>(data->data);
+
+  std::vector<uint8_t> out_of_range(MorselCount(n));
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    bool any = false;
+    for (int64_t i = begin; i < end; i++) {
+      const bool is_valid = ArrowBitGet(validity, i);
+      any |= is_valid && ((codes[i] < 0) || (codes[i] >= dictionary_length));
+      out[i] = is_valid ? static_cast<int32_t>(codes[i]) : -1;
+    }
+    out_of_range[begin / kMorselSize] = any;
+  });
+
+  for (const auto flag : out_of_range) {
+    if (flag) {
+      throw std::out_of_range("code out of bounds for the dictionary");
+    }
+  }
+
+  result->length = n;
+  result->null_count = null_count;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return result;
+}
+
+// Builds a dictionary array over a copy-free reference to the given
+// dictionary, with codes as returned by factorize
+inline DictionaryStringArray
+DictionaryFromFactorized(const Int64Array &codes, const StringArray &values) {
+  const struct ArrowArrayView *codes_view = codes.array_view_.get();
+  nanoarrow::UniqueArray dictionary;
+  values.ShareArray(dictionary.get());
+  return DictionaryStringArray(
+      NarrowCodes(codes.GetNullCount() > 0 ? codes_view : nullptr,
+                  codes_view->buffer_views[1].data.as_int64 +
+                      codes_view->offset,
+                  codes_view->length, values.array_view_->length),
+      StringArray(std::move(dictionary)));
+}
+
+// The distinct values become the dictionary and the factorized codes are
+// narrowed to int32, so nothing is hashed twice
+inline DictionaryStringArray DictionaryEncode(const StringArray &self) {
+  const auto [codes, values] = Factorize(self, std::nullopt);
+  return DictionaryFromFactorized(codes, values);
+}
+
+inline StringArray DictionaryDecode(const DictionaryStringArray &self) {
+  return TakeInternal(self.dictionary(), self.codes(),
+                      self.array_view_->length, true, std::nullopt);
+}
+
+// Binds a kernel of StringArray that computes each row on its own, so that
+// it runs once per dictionary entry instead of once per row, e.g.
+// &DictionaryWise<&IsAlpha> or &DictionaryWise<&CompareScalar<Op,
+// StringArray>, std::string_view>. String results become the dictionary of
+// a new array sharing the codes of self; anything else is gathered through
+// the codes
+template <auto Kernel, typename... Args>
+auto DictionaryWise(const DictionaryStringArray &self, Args... args) {
+  auto values = Kernel(self.dictionary(), args...);
+  if constexpr (std::is_same_v<decltype(values), StringArray>) {
+    nanoarrow::UniqueArray codes;
+    self.ShareArray(codes.get());
+    return DictionaryStringArray(std::move(codes), std::move(values));
+  } else {
+    return TakeInternal(values, self.codes(), self.array_view_->length, true,
+                        std::nullopt);
+  }
+}
+
+// Only the dictionary entries that are used are considered, in the order
+// their codes first appear. Entries repeated in the dictionary are merged
+// by running the regular unique over them
+inline StringArray DictionaryUnique(const DictionaryStringArray &self,
+                                    bool sort) {
+  const int64_t n = self.array_view_->length;
+  const int64_t dictionary_length = self.dictionary().array_view_->length;
+  const int32_t *codes = self.codes();
+
+  std::vector<uint8_t> seen(dictionary_length, 0);
+  std::vector<int32_t> order;
+  for (int64_t i = 0;
+       (i < n) && (static_cast<int64_t>(order.size()) < dictionary_length);
+       i++) {
+    const int32_t code = codes[i];
+    if ((code >= 0) && !seen[code]) {
+      seen[code] = 1;
+      order.push_back(code);
+    }
+  }
+
+  return Unique(TakeInternal(self.dictionary(), order.data(),
+                             static_cast<int64_t>(order.size()), false,
+                             std::nullopt),
+                sort);
+}
+
+inline Int64Array DictionaryCodes(const DictionaryStringArray &self) {
+  const int64_t n = self.array_view_->length;
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_INT64)) {
+    throw std::runtime_error("Unable to init int64 array!");
+  }
+
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferResize(data, n * sizeof(int64_t), false)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+  auto out = reinterpret_cast<int64_t *>(data->data);
+  const int32_t *codes = self.codes();
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      out[i] = codes[i];
+    }
+  });
+
+  result->length = n;
+  result->null_count = 0;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return Int64Array(std::move(result));
+}
+
+inline StringArray DictionaryValues(const DictionaryStringArray &self) {
+  nanoarrow::UniqueArray dictionary;
+  self.dictionary().ShareArray(dictionary.get());
+  return StringArray(std::move(dictionary));
+}
+
+inline int64_t DictionaryNbytes(const DictionaryStringArray &self) {
+  const struct ArrowArrayView *dictionary =
+      self.dictionary().array_view_.get();
+  return self.array_view_->buffer_views[1].size_bytes +
+         dictionary->buffer_views[1].size_bytes +
+         dictionary->buffer_views[2].size_bytes;
+}
+
+inline nb::object DictionaryGetItemDunder(const DictionaryStringArray &self,
+                                          nb::object indexer) {
+  const int64_t n = self.array_view_->length;
+
+  int64_t i;
+  if (nb::try_cast(indexer, i, false)) {
+    if ((i >= n) || (i < -n)) {
+      throw std::out_of_range("index out of bounds");
+    }
+    const int32_t code = self.codes()[i >= 0 ? i : i + n];
+    if (code < 0) {
+      return nb::none();
+    }
+    return GetItemDunder(self.dictionary(), nb::int_(code));
+  }
+
+  nb::slice sliceobj;
+  if (nb::try_cast(indexer, sliceobj, false)) {
+    const auto [start, _, step, slice_length] = sliceobj.compute(n);
+    if (step != 1) {
+      throw std::invalid_argument(
+          "Only slices with a step of 1 are supported for dictionary arrays");
+    }
+    return nb::cast(self.Share(static_cast<int64_t>(start),
+                               static_cast<int64_t>(slice_length)));
+  }
+
+  throw std::invalid_argument(
+      "Dictionary arrays can only be indexed by integers or slices");
+}
+
+// Each dictionary entry is converted to a str at most once, the first time
+// a row refers to it, and shared by every row with the same code
+inline nb::list DictionaryToPyList(const DictionaryStringArray &self) {
+  const int64_t n = self.array_view_->length;
+  PyObject *list = PyList_New(n);
+  if (list == nullptr) {
+    throw nb::python_error();
+  }
+  auto result = nb::steal<nb::list>(list);
+
+  const struct ArrowArrayView *dictionary =
+      self.dictionary().array_view_.get();
+  const int64_t *offsets =
+      dictionary->buffer_views[1].data.as_int64 + dictionary->offset;
+  const char *chars = dictionary->buffer_views[2].data.as_char;
+  std::vector<nb::object> strs(dictionary->length);
+
+  const int32_t *codes = self.codes();
+  for (int64_t i = 0; i < n; i++) {
+    const int32_t code = codes[i];
+    PyObject *item = Py_None;
+    if (code >= 0) {
+      if (!strs[code].is_valid()) {
+        strs[code] = nb::steal<nb::object>(NewPyStr(std::string_view(
+            chars + offsets[code],
+            static_cast<size_t>(offsets[code + 1] - offsets[code]))));
+      }
+      item = strs[code].ptr();
+    }
+    Py_INCREF(item);
+    PyList_SET_ITEM(list, i, item);
+  }
+
+  return result;
+}
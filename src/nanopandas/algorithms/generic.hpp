@@ -1,12 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <cstring>
 #include <functional>
+#include <memory>
 #include <optional>
-#include <set>
 #include <sstream>
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <nanobind/nanobind.h>
@@ -14,6 +15,13 @@
 #include <utf8proc.h>
 
 #include "../array_types.hpp"
+#include "../string_view_array.hpp"
+#include "bitmap.hpp"
+#include "builders.hpp"
+#include "hashtable.hpp"
+#include "numeric.hpp"
+#include "parallel.hpp"
+#include "pyobjects.hpp"
 
 namespace nb = nanobind;
 
@@ -43,90 +51,113 @@ static int InvertInplace(uint8_t *buf, size_t nbytes) {
 }
 
 template <typename T>
-T FromSequence([[maybe_unused]] const T &self, nb::sequence sequence) {
-  nanoarrow::UniqueArray result;
-  if (ArrowArrayInitFromType(result.get(), T::ArrowT)) {
-    throw std::runtime_error("Unable to init output array for FromSequence!");
-  }
+T FromSequence([[maybe_unused]] const T &self, nb::handle sequence) {
+  return FromPySequence<T>(sequence);
+}
 
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
+template <typename T>
+T FromFactorized([[maybe_unused]] const T &self, const Int64Array &locs,
+                 const T &values) {
+  // a code of -1 marks a missing value, which is exactly how take fills
+  const struct ArrowArrayView *locs_view = locs.array_view_.get();
+  const int64_t *codes =
+      locs_view->buffer_views[1].data.as_int64 + locs_view->offset;
+  return TakeInternal(values, codes, locs_view->length, true, std::nullopt);
+}
+
+/*
+ * Arrow PyCapsule Interface
+ * https://arrow.apache.org/docs/format/CDataInterface/PyCapsuleInterface.html
+ */
+static void ReleaseSchemaCapsule(void *ptr) noexcept {
+  auto schema = static_cast<struct ArrowSchema *>(ptr);
+  if (schema->release != nullptr) {
+    schema->release(schema);
   }
+  delete schema;
+}
 
-  for (const auto &item : sequence) {
-    if (item.is_none()) {
-      if (ArrowArrayAppendNull(result.get(), 1)) {
-        throw std::runtime_error("failed to append null!");
-      }
-    } else {
-      if constexpr (std::is_same_v<T, BoolArray> ||
-                    std::is_same_v<T, Int64Array>) {
-        auto value = nb::cast<typename T::ScalarT>(item);
-        if (ArrowArrayAppendInt(result.get(), value)) {
-          throw std::runtime_error("failed to append int value!");
-        }
-      } else if constexpr (std::is_same_v<T, StringArray>) {
-        std::string_view sv = nb::cast<std::string_view>(item);
-        const struct ArrowStringView arrow_sv = {
-            sv.data(), static_cast<int64_t>(sv.size())};
-        if (ArrowArrayAppendString(result.get(), arrow_sv)) {
-          throw std::runtime_error("failed to append string!");
-        }
-      } else {
-        // see https://stackoverflow.com/a/64354296/621736
-        static_assert(!sizeof(T), "FromSequence not implemented for type");
-      }
-    }
+static void ReleaseArrayCapsule(void *ptr) noexcept {
+  auto array = static_cast<struct ArrowArray *>(ptr);
+  if (array->release != nullptr) {
+    array->release(array);
   }
+  delete array;
+}
 
-  struct ArrowError error;
-  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
-    throw std::runtime_error("Failed to finish building: " +
-                             std::string(error.message));
+template <typename T> nb::capsule SchemaCapsule() {
+  auto schema = new struct ArrowSchema;
+  if (ArrowSchemaInitFromType(schema, T::ArrowT)) {
+    delete schema;
+    throw std::runtime_error("Unable to init schema for export!");
   }
 
-  return T(std::move(result));
+  return nb::capsule(schema, "arrow_schema", &ReleaseSchemaCapsule);
+}
+
+template <typename T> nb::capsule ArrowCSchema([[maybe_unused]] const T &self) {
+  return SchemaCapsule<T>();
 }
 
 template <typename T>
-T FromFactorized([[maybe_unused]] const T &self, const Int64Array &locs,
-                 const T &values) {
-  nanoarrow::UniqueArray result;
-  if (ArrowArrayInitFromType(result.get(), T::ArrowT)) {
-    throw std::runtime_error("Unable to init output array for FromFactorized!");
-  }
-  const auto n = locs.array_view_->length;
+std::tuple<nb::capsule, nb::capsule>
+ArrowCArray(const T &self, [[maybe_unused]] nb::object requested_schema) {
+  // requested_schema is only a hint per the protocol; we have nothing to
+  // cast to, so consumers are expected to check the schema we return
+  auto schema_capsule = SchemaCapsule<T>();
 
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not append!");
+  auto array = new struct ArrowArray;
+  self.ShareArray(array);
+
+  auto array_capsule = nb::capsule(array, "arrow_array", &ReleaseArrayCapsule);
+
+  return std::make_tuple(std::move(schema_capsule), std::move(array_capsule));
+}
+
+template <typename T> T FromArrow(nb::object obj) {
+  if (!nb::hasattr(obj, "__arrow_c_array__")) {
+    throw nb::type_error("from_arrow requires an object implementing the "
+                         "Arrow PyCapsule interface (__arrow_c_array__)");
   }
 
-  if (ArrowArrayReserve(result.get(), n)) {
-    throw std::runtime_error("Unable to reserve array!");
+  // ask the producer to cast to our storage type if it can, i.e. pyarrow will
+  // turn a string column into a large_string one
+  const auto requested_schema = SchemaCapsule<T>();
+  const auto capsules =
+      nb::cast<nb::tuple>(obj.attr("__arrow_c_array__")(requested_schema));
+  if (capsules.size() != 2) {
+    throw std::runtime_error("__arrow_c_array__ must return a 2-tuple");
   }
 
-  for (int64_t idx = 0; idx < n; idx++) {
-    const auto loc_value =
-        ArrowArrayViewGetIntUnsafe(locs.array_view_.get(), idx);
-    if (loc_value == -1) {
-      if (ArrowArrayAppendNull(result.get(), 1)) {
-        throw std::invalid_argument("Failed to append null!");
-      }
-    } else {
-      const auto value = T::ArrowGetFunc(values.array_view_.get(), loc_value);
-      if (T::ArrowAppendFunc(result.get(), value)) {
-        throw std::runtime_error("Append call failed!");
-      }
-    }
+  auto schema = static_cast<struct ArrowSchema *>(
+      PyCapsule_GetPointer(capsules[0].ptr(), "arrow_schema"));
+  if (schema == nullptr) {
+    throw nb::python_error();
+  }
+  auto c_array = static_cast<struct ArrowArray *>(
+      PyCapsule_GetPointer(capsules[1].ptr(), "arrow_array"));
+  if (c_array == nullptr) {
+    throw nb::python_error();
   }
 
   struct ArrowError error;
-  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
-    throw std::runtime_error("Failed to finish building: " +
+  struct ArrowSchemaView schema_view;
+  if (ArrowSchemaViewInit(&schema_view, schema, &error)) {
+    throw std::runtime_error("Failed to read schema: " +
                              std::string(error.message));
   }
 
-  return T(std::move(result));
+  if (schema_view.type != T::ArrowT) {
+    throw std::invalid_argument(std::string("Cannot create ") + T::Name +
+                                " from Arrow type " +
+                                ArrowTypeString(schema_view.type));
+  }
+
+  // the capsule destructor is a no-op once the array has been moved out
+  nanoarrow::UniqueArray array;
+  ArrowArrayMove(c_array, array.get());
+
+  return T(std::move(array));
 }
 
 template <typename T>
@@ -156,7 +187,8 @@ auto GetItemDunder(const T &self, nb::object indexer) -> nb::object {
                     std::is_same_v<T, Int64Array>) {
         return typename T::PyObjectT(*result);
       } else if constexpr (std::is_same_v<T, StringArray>) {
-        return typename T::PyObjectT(result->data, result->size_bytes);
+        return nb::steal<nb::str>(NewPyStr(
+            std::string_view(result->data, result->size_bytes)));
       } else {
         // see https://stackoverflow.com/a/64354296/621736
         static_assert(!sizeof(T), "__getitem__ not implemented for type");
@@ -166,6 +198,19 @@ auto GetItemDunder(const T &self, nb::object indexer) -> nb::object {
     }
   }
 
+  // Attempt 2. - BoolArray mask, checked before lists of ints as a BoolArray
+  // would otherwise be converted to one
+  if (nb::isinstance<BoolArray>(indexer)) {
+    const auto &mask = nb::cast<const BoolArray &>(indexer);
+    T *out = [&] {
+      nb::gil_scoped_release release;
+      return new T(FilterByMask(self, mask));
+    }();
+
+    nb::handle py_type = nb::type<T>();
+    return nb::inst_take_ownership(py_type, out);
+  }
+
   // At this point we are working with an iterable
   // TODO: we are falling back to return Python containers, but ideally we
   // should still return T wrapped as a Python object
@@ -178,7 +223,7 @@ auto GetItemDunder(const T &self, nb::object indexer) -> nb::object {
     throw std::runtime_error("Could not start appending");
   }
 
-  // Attempt 2. - list of ints
+  // Attempt 3. - list of ints
   std::vector<std::optional<int64_t>> values;
   if (nb::try_cast(indexer, values, false)) {
     for (const auto idx : values) {
@@ -210,42 +255,41 @@ auto GetItemDunder(const T &self, nb::object indexer) -> nb::object {
     return nb::inst_take_ownership(py_type, out);
   }
 
-  // Attempt 3. - ndarray
+  // Attempt 4. - numpy boolean mask
   nb::ndarray<const bool, nb::ndim<1>> array;
   if (nb::try_cast(indexer, array, false)) {
-    auto v = array.view();
-    for (size_t idx = 0; idx < v.shape(0); idx++) {
-      const auto should_index = v(idx);
-      if (should_index) {
-        if (const auto value = GetItemDunderInternal(self, idx)) {
-          if (T::ArrowAppendFunc(result.get(), *value)) {
-            throw std::runtime_error("Append call failed!");
-          }
-        } else {
-          if (ArrowArrayAppendNull(result.get(), 1)) {
-            throw std::runtime_error("failed to append null!");
-          }
-        }
-      }
+    if (static_cast<int64_t>(array.shape(0)) != self.array_view_->length) {
+      throw std::out_of_range("boolean index has wrong length");
     }
 
-    struct ArrowError error;
-    if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
-      throw std::runtime_error("Failed to finish building: " +
-                               std::string(error.message));
-    }
+    const auto v = array.view();
+    T *out = [&] {
+      nb::gil_scoped_release release;
+      return new T(Filter(self, [&v](int64_t i, int64_t nbits) {
+        return PackWord(i, nbits, [&v](int64_t j) { return v(j); });
+      }));
+    }();
 
     nb::handle py_type = nb::type<T>();
-    T *out = new T(std::move(result));
     return nb::inst_take_ownership(py_type, out);
   }
 
-  // Attempt 4. - slice
+  // Attempt 5. - slice
   nb::slice sliceobj;
   if (nb::try_cast(indexer, sliceobj, false)) {
     const auto converted_slice = sliceobj.compute(self.array_view_->length);
     const auto [start, _, step, slice_length] = converted_slice;
 
+    // contiguous slices are views that keep the parent buffers alive
+    if (step == 1) {
+      nanoarrow::UniqueArray view;
+      self.ShareArray(view.get(), start, slice_length);
+
+      nb::handle py_type = nb::type<T>();
+      T *out = new T(std::move(view));
+      return nb::inst_take_ownership(py_type, out);
+    }
+
     auto idx = start;
     for (size_t i = 0; i < slice_length; i++) {
       if (const auto value = GetItemDunderInternal(self, idx)) {
@@ -276,74 +320,6 @@ auto GetItemDunder(const T &self, nb::object indexer) -> nb::object {
       "(`None`) and integer or boolean arrays are valid indices");
 }
 
-template <typename T> BoolArray EqDunder(const T &self, const T &other) {
-  nanoarrow::UniqueArray result;
-  if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_BOOL)) {
-    throw std::runtime_error("Unable to init bool array!");
-  }
-  const auto n = self.array_view_->length;
-
-  if (n != other.array_view_->length) {
-    throw std::range_error("Arrays are not of equal size");
-  }
-
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
-  }
-
-  if (ArrowArrayReserve(result.get(), n)) {
-    throw std::runtime_error("Unable to reserve array!");
-  }
-
-  for (int64_t i = 0; i < n; i++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), i) ||
-        ArrowArrayViewIsNull(other.array_view_.get(), i)) {
-      if (ArrowArrayAppendNull(result.get(), 1)) {
-        throw std::runtime_error("failed to append null!");
-      }
-    } else {
-      bool is_equal = false;
-      if constexpr (std::is_same_v<T, BoolArray> ||
-                    std::is_same_v<T, Int64Array>) {
-        const auto left = ArrowArrayViewGetIntUnsafe(self.array_view_.get(), i);
-        const auto right =
-            ArrowArrayViewGetIntUnsafe(other.array_view_.get(), i);
-        is_equal = left == right;
-      } else if constexpr (std::is_same_v<T, StringArray>) {
-        const auto left =
-            ArrowArrayViewGetStringUnsafe(self.array_view_.get(), i);
-        const auto right =
-            ArrowArrayViewGetStringUnsafe(other.array_view_.get(), i);
-        const auto nbytes = left.size_bytes;
-        is_equal =
-            (nbytes == right.size_bytes) &&
-            (!strncmp(left.data, right.data, static_cast<size_t>(nbytes)));
-      } else {
-        // see https://stackoverflow.com/a/64354296/621736
-        static_assert(!sizeof(T), "__eq__ not implemented for type");
-      }
-
-      if (is_equal) {
-        if (ArrowArrayAppendInt(result.get(), 1)) {
-          throw std::runtime_error("failed to append true value!");
-        }
-      } else {
-        if (ArrowArrayAppendInt(result.get(), 0)) {
-          throw std::runtime_error("failed to append false value!");
-        }
-      }
-    }
-  }
-
-  struct ArrowError error;
-  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
-    throw std::runtime_error("Failed to finish building: " +
-                             std::string(error.message));
-  }
-
-  return result;
-}
-
 template <typename T> std::string ReprDunder(const T &self) {
   std::ostringstream out{};
   out << T::Name << "\n[";
@@ -413,15 +389,15 @@ template <typename T> int64_t Size(const T &self) {
 }
 
 template <typename T> int64_t NullCount(const T &self) {
-  return self.array_view_->null_count;
+  return self.GetNullCount();
 }
 
 template <typename T> bool Any(const T &self) {
-  return self.array_view_->length > self.array_view_->null_count;
+  return self.array_view_->length > self.GetNullCount();
 }
 
 template <typename T> bool All(const T &self) {
-  return self.array_view_->null_count == 0;
+  return self.GetNullCount() == 0;
 }
 
 template <typename T> BoolArray IsNA(const T &self) {
@@ -440,10 +416,10 @@ template <typename T> BoolArray IsNA(const T &self) {
       throw std::runtime_error("ArrowBufferAppendFill failed");
     }
   } else {
-    if (ArrowBufferReserve(buffer, bytes_required)) {
-      throw std::runtime_error("Could not reserve arrow buffer");
+    if (ArrowBufferAppendFill(buffer, 0, bytes_required)) {
+      throw std::runtime_error("ArrowBufferAppendFill failed");
     }
-    ArrowBufferAppendUnsafe(buffer, src, bytes_required);
+    CopyBitmap(src, self.array_view_->offset, buffer->data, 0, n);
   }
 
   result->length = n;
@@ -464,80 +440,374 @@ template <typename T> BoolArray IsNA(const T &self) {
   return BoolArray(std::move(result));
 }
 
-template <typename T>
-T Take(const T &self, const std::vector<int64_t> &indices) {
+// Gathers self at the given positions. With allow_fill a -1 index produces
+// fill_value (or a null if there is none) and any other negative index is
+// invalid, matching pandas ExtensionArray.take; without it negative indices
+// count back from the end. Indices may be of any integer type. Does not
+// touch any Python objects so it can be called with the GIL released
+template <typename T, typename I>
+T TakeInternal(const T &self, const I *indices, int64_t n,
+               bool allow_fill,
+               const std::optional<typename T::ScalarT> &fill_value) {
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const int64_t length = array_view->length;
+  const int64_t offset = array_view->offset;
+
+  // validate everything up front so the gather loops can run unchecked
+  int64_t min_index = 0;
+  int64_t max_index = -1;
+  if (n > 0) {
+    min_index = max_index = indices[0];
+    for (int64_t i = 1; i < n; i++) {
+      min_index = std::min<int64_t>(min_index, indices[i]);
+      max_index = std::max<int64_t>(max_index, indices[i]);
+    }
+
+    if (max_index >= length) {
+      throw std::out_of_range("index out of bounds!");
+    }
+    if (allow_fill && (min_index < -1)) {
+      throw std::invalid_argument("Invalid value in 'indices'. Must be all "
+                                  ">= -1 when allow_fill is True");
+    }
+    if (!allow_fill && (min_index < -length)) {
+      throw std::out_of_range("index out of bounds!");
+    }
+  }
+
+  const bool needs_fill = allow_fill && (min_index == -1);
+  const auto resolve = [allow_fill, length](int64_t index) {
+    return (index < 0 && !allow_fill) ? index + length : index;
+  };
+
   nanoarrow::UniqueArray result;
   if (ArrowArrayInitFromType(result.get(), T::ArrowT)) {
     throw std::runtime_error("Unable to init output array for take!");
   }
 
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
-  }
+  const uint8_t *src_validity =
+      self.GetNullCount() > 0 ? array_view->buffer_views[0].data.as_uint8
+                              : nullptr;
+  const bool fill_is_null = !fill_value.has_value();
 
-  if (ArrowArrayReserve(result.get(), indices.size())) {
-    throw std::runtime_error("Unable to reserve array!");
+  int64_t null_count = 0;
+  if ((src_validity != nullptr) || (needs_fill && fill_is_null)) {
+    struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result.get());
+    if (ArrowBufferAppendFill(&bitmap->buffer, 0, _ArrowBytesForBits(n))) {
+      throw std::runtime_error("Unable to allocate validity bitmap!");
+    }
+
+    std::vector<int64_t> morsel_null_counts(MorselCount(n), 0);
+    ParallelFor(n, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i += 64) {
+        const int64_t block = std::min<int64_t>(64, end - i);
+        uint64_t word = 0;
+        for (int64_t j = 0; j < block; j++) {
+          const int64_t idx = resolve(indices[i + j]);
+          const bool is_valid =
+              idx < 0 ? !fill_is_null
+                      : (src_validity == nullptr ||
+                         ArrowBitGet(src_validity, offset + idx));
+          word |= static_cast<uint64_t>(is_valid) << j;
+        }
+        morsel_null_counts[begin / kMorselSize] += block - PopCount(word);
+        StoreBitmapWord(bitmap->buffer.data, i, word, block);
+      }
+    });
+    for (const auto morsel_null_count : morsel_null_counts) {
+      null_count += morsel_null_count;
+    }
+    bitmap->size_bits = n;
   }
 
-  const auto n = self.array_view_.get()->length;
+  // string views keep referring to the character data of self
+  [[maybe_unused]] std::shared_ptr<const StringViewBuffers> view_buffers;
+  if constexpr (std::is_same_v<T, BoolArray>) {
+    const uint8_t *src = array_view->buffer_views[1].data.as_uint8;
+    const bool fill = fill_value.value_or(false);
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferAppendFill(data, 0, _ArrowBytesForBits(n))) {
+      throw std::runtime_error("Unable to allocate data buffer!");
+    }
 
-  for (const auto index : indices) {
-    if ((index >= n) || (index < -n)) {
-      throw std::range_error("index out of bounds!");
+    ParallelFor(n, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i += 64) {
+        const int64_t block = std::min<int64_t>(64, end - i);
+        uint64_t word = 0;
+        for (int64_t j = 0; j < block; j++) {
+          const int64_t idx = resolve(indices[i + j]);
+          const bool value = idx < 0 ? fill : ArrowBitGet(src, offset + idx);
+          word |= static_cast<uint64_t>(value) << j;
+        }
+        StoreBitmapWord(data->data, i, word, block);
+      }
+    });
+  } else if constexpr (std::is_same_v<T, Int64Array>) {
+    const int64_t *src = array_view->buffer_views[1].data.as_int64 + offset;
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferResize(data, n * sizeof(int64_t), false)) {
+      throw std::runtime_error("Unable to allocate data buffer!");
     }
+    auto out = reinterpret_cast<int64_t *>(data->data);
 
-    const auto idx = index >= 0 ? index : n + index;
-    if (ArrowArrayViewIsNull(self.array_view_.get(), idx)) {
-      if (ArrowArrayAppendNull(result.get(), 1)) {
-        throw std::runtime_error("failed to append null!");
+    const int64_t fill = fill_value.value_or(0);
+    ParallelFor(n, [&](int64_t begin, int64_t end) {
+      if (!needs_fill) {
+        for (int64_t i = begin; i < end; i++) {
+          out[i] = src[resolve(indices[i])];
+        }
+      } else {
+        for (int64_t i = begin; i < end; i++) {
+          const int64_t idx = indices[i];
+          out[i] = idx < 0 ? fill : src[idx];
+        }
       }
-    } else {
-      const auto value = T::ArrowGetFunc(self.array_view_.get(), idx);
-      if (T::ArrowAppendFunc(result.get(), value)) {
-        throw std::runtime_error("Append call failed!");
+    });
+  } else if constexpr (std::is_same_v<T, StringArray>) {
+    const int64_t *src_offsets =
+        array_view->buffer_views[1].data.as_int64 + offset;
+    const char *src_data = array_view->buffer_views[2].data.as_char;
+    const std::string_view fill = fill_value.value_or(std::string_view{});
+
+    BuildStringBuffers(result.get(), n, [&](int64_t i) -> std::string_view {
+      const int64_t idx = resolve(indices[i]);
+      if (idx < 0) {
+        return fill;
+      }
+      return {src_data + src_offsets[idx],
+              static_cast<size_t>(src_offsets[idx + 1] - src_offsets[idx])};
+    });
+  } else if constexpr (std::is_same_v<T, StringViewArray>) {
+    // only the views are gathered; the characters stay where they are. A
+    // fill value too long to be inlined gets a buffer of its own
+    view_buffers = self.buffers();
+    StringViewEntry fill{};
+    if (needs_fill && fill_value.has_value()) {
+      fill = MakeStringView(*fill_value, 0, 0);
+      if (fill.size > kMaxInlineStringSize) {
+        auto extended = std::make_shared<StringViewBuffers>(*view_buffers);
+        const auto owner = std::make_shared<const StringArray>(
+            std::vector<std::optional<std::string_view>>{*fill_value});
+        extended->owners.push_back(owner);
+        extended->data.push_back(
+            owner->array_view_->buffer_views[2].data.as_char);
+        fill.buffer_index = static_cast<int32_t>(extended->data.size() - 1);
+        view_buffers = std::move(extended);
       }
     }
+
+    const StringViewEntry *src = self.views();
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferResize(data, n * sizeof(StringViewEntry), false)) {
+      throw std::runtime_error("Unable to allocate data buffer!");
+    }
+    auto out = reinterpret_cast<StringViewEntry *>(data->data);
+    ParallelFor(n, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const int64_t idx = resolve(indices[i]);
+        out[i] = idx < 0 ? fill : src[idx];
+      }
+    });
+  } else {
+    // see https://stackoverflow.com/a/64354296/621736
+    static_assert(!sizeof(T), "take not implemented for type");
   }
 
+  result->length = n;
+  result->null_count = null_count;
+
   struct ArrowError error;
   if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
     throw std::runtime_error("Failed to finish building: " +
                              std::string(error.message));
   }
 
-  return T(std::move(result));
+  if constexpr (std::is_same_v<T, StringViewArray>) {
+    return T(std::move(result), std::move(view_buffers));
+  } else {
+    return T(std::move(result));
+  }
 }
 
-template <typename T> T Copy(const T &self) {
-  // This implementation is pretty naive; could be a lot faster if we
-  // just memcpy the required buffers
+template <typename T>
+T Take(const T &self, nb::handle indices, bool allow_fill,
+       nb::object fill_value) {
+  std::optional<typename T::ScalarT> fill;
+  if (!fill_value.is_none()) {
+    fill = nb::cast<typename T::ScalarT>(fill_value);
+  }
+
+  if (nb::isinstance<Int64Array>(indices)) {
+    const auto &locs = nb::cast<const Int64Array &>(indices);
+    if (locs.GetNullCount() > 0) {
+      throw std::invalid_argument("indices cannot contain nulls");
+    }
+    const int64_t *data = locs.array_view_->buffer_views[1].data.as_int64 +
+                          locs.array_view_->offset;
+
+    nb::gil_scoped_release release;
+    return TakeInternal(self, data, locs.array_view_->length, allow_fill,
+                        fill);
+  }
+
+  nb::ndarray<const int64_t, nb::ndim<1>, nb::c_contig> array;
+  if (nb::try_cast(indices, array, false)) {
+    nb::gil_scoped_release release;
+    return TakeInternal(self, array.data(),
+                        static_cast<int64_t>(array.shape(0)), allow_fill,
+                        fill);
+  }
+
+  // fall back to any sequence of Python integers
+  const auto values = nb::cast<std::vector<int64_t>>(indices);
+  nb::gil_scoped_release release;
+  return TakeInternal(self, values.data(), static_cast<int64_t>(values.size()),
+                      allow_fill, fill);
+}
+
+// Returns the positions in [0, n) whose bit is set in the mask, where
+// mask_word(i, nbits) returns the mask bits for [i, i + nbits). The mask is
+// popcounted first so the positions are allocated exactly once, after which
+// each morsel scans the set bits of its words with count trailing zeros
+template <typename WordFunc>
+std::vector<int64_t> MaskPositions(int64_t n, WordFunc &&mask_word) {
+  std::vector<int64_t> morsel_starts(MorselCount(n) + 1, 0);
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    int64_t count = 0;
+    for (int64_t i = begin; i < end; i += 64) {
+      count += PopCount(mask_word(i, std::min<int64_t>(64, end - i)));
+    }
+    morsel_starts[begin / kMorselSize + 1] = count;
+  });
+  for (size_t morsel = 1; morsel < morsel_starts.size(); morsel++) {
+    morsel_starts[morsel] += morsel_starts[morsel - 1];
+  }
+
+  std::vector<int64_t> positions(morsel_starts.back());
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    int64_t *out = positions.data() + morsel_starts[begin / kMorselSize];
+    for (int64_t i = begin; i < end; i += 64) {
+      uint64_t word = mask_word(i, std::min<int64_t>(64, end - i));
+      while (word != 0) {
+        *out++ = i + CountTrailingZeros(word);
+        word &= word - 1;
+      }
+    }
+  });
+
+  return positions;
+}
+
+// Keeps the rows of self whose bit is set in the mask, see MaskPositions.
+// BMI2 / AVX-512 compress instructions are not used, as the bit scan is
+// portable and the gather that follows dominates
+template <typename T, typename WordFunc>
+T Filter(const T &self, WordFunc &&mask_word) {
+  const auto positions = MaskPositions(self.array_view_->length,
+                                       std::forward<WordFunc>(mask_word));
+  return TakeInternal(self, positions.data(),
+                      static_cast<int64_t>(positions.size()), false,
+                      std::nullopt);
+}
+
+// Filters by a BoolArray, treating null entries of the mask as false like
+// pandas does
+template <typename T> T FilterByMask(const T &self, const BoolArray &mask) {
+  const struct ArrowArrayView *mask_view = mask.array_view_.get();
+  if (mask_view->length != self.array_view_->length) {
+    throw std::out_of_range("boolean index has wrong length");
+  }
+
+  const uint8_t *data = mask_view->buffer_views[1].data.as_uint8;
+  const uint8_t *validity = mask.GetNullCount() > 0
+                                ? mask_view->buffer_views[0].data.as_uint8
+                                : nullptr;
+  const int64_t offset = mask_view->offset;
+  return Filter(self, [=](int64_t i, int64_t nbits) {
+    const uint64_t word = LoadBitmapWord(data, offset + i, nbits);
+    return validity == nullptr
+               ? word
+               : word & LoadBitmapWord(validity, offset + i, nbits);
+  });
+}
+
+template <typename T> T Copy(const T &self, bool deep) {
+  // the buffers of an array are never mutated after construction, so a
+  // shallow copy can simply share them with the parent
+  if (!deep) {
+    nanoarrow::UniqueArray result;
+    self.ShareArray(result.get());
+    return T(std::move(result));
+  }
+
   nanoarrow::UniqueArray result;
   if (ArrowArrayInitFromType(result.get(), T::ArrowT)) {
     throw std::runtime_error("Unable to init output for copy!");
   }
-  const auto n = self.array_view_->length;
 
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
-  }
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const auto n = array_view->length;
+  const auto offset = array_view->offset;
 
-  if (ArrowArrayReserve(result.get(), n)) {
-    throw std::runtime_error("Unable to reserve array!");
+  const uint8_t *validity = array_view->buffer_views[0].data.as_uint8;
+  if (validity != nullptr) {
+    struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result.get());
+    if (ArrowBufferAppendFill(&bitmap->buffer, 0, _ArrowBytesForBits(n))) {
+      throw std::runtime_error("Unable to allocate validity bitmap!");
+    }
+    CopyBitmap(validity, offset, bitmap->buffer.data, 0, n);
+    bitmap->size_bits = n;
   }
 
-  for (int64_t idx = 0; idx < n; idx++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), idx)) {
-      if (ArrowArrayAppendNull(result.get(), 1)) {
-        throw std::runtime_error("failed to append null!");
-      }
+  if constexpr (std::is_same_v<T, BoolArray>) {
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferAppendFill(data, 0, _ArrowBytesForBits(n))) {
+      throw std::runtime_error("Unable to allocate data buffer!");
+    }
+    CopyBitmap(array_view->buffer_views[1].data.as_uint8, offset, data->data,
+               0, n);
+  } else if constexpr (std::is_same_v<T, Int64Array>) {
+    const int64_t *src = array_view->buffer_views[1].data.as_int64 + offset;
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferAppend(data, src, n * sizeof(int64_t))) {
+      throw std::runtime_error("Unable to copy data buffer!");
+    }
+  } else if constexpr (std::is_same_v<T, StringArray>) {
+    const int64_t *src_offsets =
+        array_view->buffer_views[1].data.as_int64 + offset;
+    const int64_t first = n > 0 ? src_offsets[0] : 0;
+    const int64_t last = n > 0 ? src_offsets[n] : 0;
+
+    struct ArrowBuffer *offsets = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferReserve(offsets, (n + 1) * sizeof(int64_t))) {
+      throw std::runtime_error("Unable to allocate offsets buffer!");
+    }
+    auto dst_offsets = reinterpret_cast<int64_t *>(offsets->data);
+    if (n == 0) {
+      dst_offsets[0] = 0;
+    } else if (first == 0) {
+      std::memcpy(dst_offsets, src_offsets, (n + 1) * sizeof(int64_t));
     } else {
-      const auto value = T::ArrowGetFunc(self.array_view_.get(), idx);
-      if (T::ArrowAppendFunc(result.get(), value)) {
-        throw std::runtime_error("Append call failed!");
+      // sliced arrays start partway into the data buffer
+      for (int64_t i = 0; i < n + 1; i++) {
+        dst_offsets[i] = src_offsets[i] - first;
       }
     }
+    offsets->size_bytes = (n + 1) * sizeof(int64_t);
+
+    const char *src = array_view->buffer_views[2].data.as_char + first;
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 2);
+    if (ArrowBufferAppend(data, src, last - first)) {
+      throw std::runtime_error("Unable to copy data buffer!");
+    }
+  } else {
+    // see https://stackoverflow.com/a/64354296/621736
+    static_assert(!sizeof(T), "copy not implemented for type");
   }
 
+  result->length = n;
+  result->null_count = self.GetNullCount();
+
   struct ArrowError error;
   if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
     throw std::runtime_error("Failed to finish building: " +
@@ -555,15 +825,15 @@ template <typename T> T FillNA(const T &self, typename T::ScalarT replacement) {
 
   const auto n = self.array_view_->length;
 
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
-  }
+  if constexpr (std::is_same_v<T, BoolArray> || std::is_same_v<T, Int64Array>) {
+    if (ArrowArrayStartAppending(result.get())) {
+      throw std::runtime_error("Could not start appending");
+    }
 
-  if (ArrowArrayReserve(result.get(), n)) {
-    throw std::runtime_error("Unable to reserve array!");
-  }
+    if (ArrowArrayReserve(result.get(), n)) {
+      throw std::runtime_error("Unable to reserve array!");
+    }
 
-  if constexpr (std::is_same_v<T, BoolArray> || std::is_same_v<T, Int64Array>) {
     for (int64_t idx = 0; idx < self.array_view_.get()->length; idx++) {
       if (ArrowArrayViewIsNull(self.array_view_.get(), idx)) {
         if (ArrowArrayAppendInt(result.get(), replacement)) {
@@ -577,21 +847,17 @@ template <typename T> T FillNA(const T &self, typename T::ScalarT replacement) {
       }
     }
   } else if constexpr (std::is_same_v<T, StringArray>) {
-    const struct ArrowStringView replacement_sv = {
-        replacement.data(), static_cast<int64_t>(replacement.size())};
-    for (int64_t idx = 0; idx < self.array_view_.get()->length; idx++) {
-      if (ArrowArrayViewIsNull(self.array_view_.get(), idx)) {
-        if (ArrowArrayAppendString(result.get(), replacement_sv)) {
-          throw std::runtime_error("failed to append string!");
-        }
-      } else {
-        const auto sv =
-            ArrowArrayViewGetStringUnsafe(self.array_view_.get(), idx);
-        if (ArrowArrayAppendString(result.get(), sv)) {
-          throw std::runtime_error("failed to append string!");
-        }
+    const struct ArrowArrayView *array_view = self.array_view_.get();
+    const bool has_nulls = self.GetNullCount() > 0;
+    BuildStringBuffers(result.get(), n, [&](int64_t i) -> std::string_view {
+      if (has_nulls && ArrowArrayViewIsNull(array_view, i)) {
+        return replacement;
       }
-    }
+      const auto sv = ArrowArrayViewGetStringUnsafe(array_view, i);
+      return {sv.data, static_cast<size_t>(sv.size_bytes)};
+    });
+    result->length = n;
+    result->null_count = 0;
   } else {
     // see https://stackoverflow.com/a/64354296/621736
     static_assert(!sizeof(T), "fillna not implemented for type");
@@ -607,88 +873,22 @@ template <typename T> T FillNA(const T &self, typename T::ScalarT replacement) {
 }
 
 template <typename T> T DropNA(const T &self) {
-  nanoarrow::UniqueArray result;
-  if (ArrowArrayInitFromType(result.get(), T::ArrowT)) {
-    throw std::runtime_error("Unable to init dropna output array!");
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const uint8_t *validity = array_view->buffer_views[0].data.as_uint8;
+  if (self.GetNullCount() == 0) {
+    return Copy(self, false);
   }
 
-  const auto n = self.array_view_->length - self.array_view_->null_count;
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
-  }
-
-  if (ArrowArrayReserve(result.get(), n)) {
-    throw std::runtime_error("Unable to reserve array!");
-  }
-
-  for (int64_t idx = 0; idx < self.array_view_.get()->length; idx++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), idx)) {
-      continue;
-    } else {
-      const auto value = T::ArrowGetFunc(self.array_view_.get(), idx);
-      if (T::ArrowAppendFunc(result.get(), value)) {
-        throw std::runtime_error("Append call failed!");
-      }
-    }
-  }
-
-  struct ArrowError error;
-  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
-    throw std::runtime_error("Failed to finish building: " +
-                             std::string(error.message));
-  }
-
-  return T(std::move(result));
+  const int64_t offset = array_view->offset;
+  return Filter(self, [=](int64_t i, int64_t nbits) {
+    return LoadBitmapWord(validity, offset + i, nbits);
+  });
 }
 
 template <typename T> T Interpolate(const T &self) {
-  nanoarrow::UniqueArray result;
-  if (ArrowArrayInitFromType(result.get(), T::ArrowT)) {
-    throw std::runtime_error("Unable to init output for interpolate!");
-  }
-
-  // TODO: check for overflow
-  const auto n = self.array_view_->length;
-
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
-  }
-
-  if (ArrowArrayReserve(result.get(), n)) {
-    throw std::runtime_error("Unable to reserve array!");
-  }
-
-  bool seen_value = false;
-  typename T::ArrowScalarT last_value_seen;
-
-  for (int64_t idx = 0; idx < self.array_view_.get()->length; idx++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), idx)) {
-      if (!seen_value) {
-        if (ArrowArrayAppendNull(result.get(), 1)) {
-          throw std::runtime_error("failed to append null!");
-        }
-      } else {
-        if (T::ArrowAppendFunc(result.get(), last_value_seen)) {
-          throw std::runtime_error("Append call failed!");
-        }
-      }
-    } else {
-      seen_value = true;
-      const auto value = T::ArrowGetFunc(self.array_view_.get(), idx);
-      if (T::ArrowAppendFunc(result.get(), value)) {
-        throw std::runtime_error("Append call failed!");
-      }
-      last_value_seen = value;
-    }
-  }
-
-  struct ArrowError error;
-  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
-    throw std::runtime_error("Failed to finish building: " +
-                             std::string(error.message));
-  }
-
-  return T(std::move(result));
+  // there is nothing to interpolate between for the types we have, so this
+  // behaves like a forward fill
+  return PadOrBackfill(self, "pad");
 }
 
 template <typename T> T PadOrBackfill(const T &self, std::string_view method) {
@@ -696,323 +896,363 @@ template <typename T> T PadOrBackfill(const T &self, std::string_view method) {
     throw std::invalid_argument("'method' must be either 'pad' or 'backfill'");
   }
 
-  nanoarrow::UniqueArray result;
-  if (ArrowArrayInitFromType(result.get(), T::ArrowT)) {
-    throw std::runtime_error("Unable to init large string array!");
-  }
-
-  const auto n = self.array_view_->length;
-
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
-  }
-
-  if (ArrowArrayReserve(result.get(), n)) {
-    throw std::runtime_error("Unable to reserve array!");
-  }
+  // resolve the position each row is filled from, then gather in one go so
+  // that variable length output is sized before anything is copied. Rows
+  // with no value to fill from map to -1 and stay null
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const auto n = array_view->length;
+  std::vector<int64_t> sources(n);
 
+  int64_t source = -1;
   if (method == "pad") {
-    bool seen_value = false;
-    typename T::ArrowScalarT last_value_seen;
-    for (int64_t idx = 0; idx < self.array_view_.get()->length; idx++) {
-      if (ArrowArrayViewIsNull(self.array_view_.get(), idx)) {
-        if (!seen_value) {
-          if (ArrowArrayAppendNull(result.get(), 1)) {
-            throw std::runtime_error("failed to append null!");
-          }
-        } else {
-          if (T::ArrowAppendFunc(result.get(), last_value_seen)) {
-            throw std::runtime_error("Append call failed!");
-          }
-        }
-      } else {
-        seen_value = true;
-        const auto value = T::ArrowGetFunc(self.array_view_.get(), idx);
-        if (T::ArrowAppendFunc(result.get(), value)) {
-          throw std::runtime_error("Append call failed!");
-        }
-        last_value_seen = value;
+    for (int64_t idx = 0; idx < n; idx++) {
+      if (!ArrowArrayViewIsNull(array_view, idx)) {
+        source = idx;
       }
+      sources[idx] = source;
     }
   } else {
-
-    int64_t last_append = 0;
-    for (int64_t idx = 0; idx < self.array_view_.get()->length; idx++) {
-      if (ArrowArrayViewIsNull(self.array_view_.get(), idx)) {
-        if (idx == self.array_view_.get()->length - 1) {
-          do {
-            if (ArrowArrayAppendNull(result.get(), 1)) {
-              throw std::runtime_error("failed to append null!");
-            }
-            last_append++;
-          } while (last_append <= idx);
-        }
-        continue;
-      } else {
-        const auto value = T::ArrowGetFunc(self.array_view_.get(), idx);
-        do {
-          if (T::ArrowAppendFunc(result.get(), value)) {
-            throw std::runtime_error("Append call failed!");
-          }
-          last_append++;
-        } while (last_append <= idx);
+    for (int64_t idx = n - 1; idx >= 0; idx--) {
+      if (!ArrowArrayViewIsNull(array_view, idx)) {
+        source = idx;
       }
+      sources[idx] = source;
     }
   }
 
-  struct ArrowError error;
-  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
-    throw std::runtime_error("Failed to finish building: " +
-                             std::string(error.message));
-  }
-
-  return T(std::move(result));
+  return TakeInternal(self, sources.data(), n, true, std::nullopt);
 }
 
-template <typename T> T Unique(const T &self) {
-  std::set<typename T::ScalarT> uniques;
-  const auto n = self.array_view_->length;
+// default starting capacity for the hash tables in Unique/Factorize; they
+// grow as needed, so this only avoids rehashing for low cardinality data
+constexpr int64_t kDefaultSizeHint = 1024;
+
+// Hashes every non-null value of self, returning the position of the first
+// occurrence of each distinct value in order of appearance. If codes is not
+// null it receives the index of each value into that result (-1 for nulls)
+template <typename T>
+std::vector<int64_t> DistinctPositions(const T &self, int64_t size_hint,
+                                       int64_t *codes) {
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const int64_t n = array_view->length;
+  const int64_t offset = array_view->offset;
+  const bool has_nulls = self.GetNullCount() > 0;
+
+  HashTable table(size_hint);
+  std::vector<int64_t> first_positions;
 
   for (int64_t i = 0; i < n; i++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), i)) {
+    if (has_nulls && ArrowArrayViewIsNull(array_view, i)) {
+      if (codes != nullptr) {
+        codes[i] = -1;
+      }
       continue;
     }
 
-    if constexpr (std::is_same_v<T, BoolArray> ||
-                  std::is_same_v<T, Int64Array>) {
-      const auto value = ArrowArrayViewGetIntUnsafe(self.array_view_.get(), i);
-      uniques.insert(value);
+    std::pair<int64_t, bool> found;
+    if constexpr (std::is_same_v<T, BoolArray>) {
+      const auto value =
+          ArrowBitGet(array_view->buffer_views[1].data.as_uint8, offset + i);
+      found = table.FindOrInsert(MixHash(value), [](int64_t) { return true; });
+    } else if constexpr (std::is_same_v<T, Int64Array>) {
+      const auto value = array_view->buffer_views[1].data.as_int64[offset + i];
+      found = table.FindOrInsert(MixHash(static_cast<uint64_t>(value)),
+                                 [](int64_t) { return true; });
     } else if constexpr (std::is_same_v<T, StringArray>) {
-      const auto sv = ArrowArrayViewGetStringUnsafe(self.array_view_.get(), i);
-      const std::string_view value{sv.data, static_cast<size_t>(sv.size_bytes)};
-      uniques.insert(value);
+      // compare against the bytes of the first occurrence in the source
+      // buffer rather than storing a copy of each distinct value
+      const int64_t *offsets =
+          array_view->buffer_views[1].data.as_int64 + offset;
+      const char *data = array_view->buffer_views[2].data.as_char;
+      const char *value = data + offsets[i];
+      const int64_t nbytes = offsets[i + 1] - offsets[i];
+
+      const auto is_equal = [&](int64_t id) {
+        const int64_t pos = first_positions[id];
+        return (offsets[pos + 1] - offsets[pos] == nbytes) &&
+               !std::memcmp(data + offsets[pos], value,
+                            static_cast<size_t>(nbytes));
+      };
+      found = table.FindOrInsert(HashBytes(value, nbytes), is_equal);
+    } else if constexpr (std::is_same_v<T, StringViewArray>) {
+      const StringViewEntry *views = self.views();
+      const std::string_view value = self.Value(views[i]);
+      const auto is_equal = [&](int64_t id) {
+        const StringViewEntry &other = views[first_positions[id]];
+        return StringViewsEqual(
+            views[i], other, [&] { return value; },
+            [&] { return self.Value(other); });
+      };
+      found = table.FindOrInsert(HashBytes(value.data(), views[i].size),
+                                 is_equal);
     } else {
       // see https://stackoverflow.com/a/64354296/621736
-      static_assert(!sizeof(T), "Unique not implemented for type");
+      static_assert(!sizeof(T), "hashing not implemented for type");
     }
-  }
 
-  nanoarrow::UniqueArray result;
-  if (ArrowArrayInitFromType(result.get(), T::ArrowT)) {
-    throw std::runtime_error("Unable to init large string array!");
+    const auto [id, inserted] = found;
+    if (inserted) {
+      first_positions.push_back(i);
+    }
+    if (codes != nullptr) {
+      codes[i] = id;
+    }
   }
 
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
-  }
+  return first_positions;
+}
 
-  if (ArrowArrayReserve(result.get(), uniques.size())) {
-    throw std::runtime_error("Unable to reserve array!");
-  }
+// ranges of integers up to this size are deduplicated with a flat lookup
+// table instead of hashing
+constexpr int64_t kMaxDirectIndexRange = 1 << 16;
 
-  // TODO: can make generic if we hash ArrowString
-  for (const auto &val : uniques) {
-    if constexpr (std::is_same_v<T, BoolArray> ||
-                  std::is_same_v<T, Int64Array>) {
-      if (ArrowArrayAppendInt(result.get(), val)) {
-        throw std::runtime_error("failed to append int!");
+// Low cardinality fast path for Unique. Returns false without touching
+// positions if the values span too wide a range to index directly
+template <typename T>
+bool DirectIndexedPositions(const T &self, std::vector<int64_t> &positions) {
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const int64_t n = array_view->length;
+  const int64_t offset = array_view->offset;
+  const bool has_nulls = self.GetNullCount() > 0;
+
+  if constexpr (std::is_same_v<T, BoolArray>) {
+    const uint8_t *data = array_view->buffer_views[1].data.as_uint8;
+    bool seen[2] = {false, false};
+    for (int64_t i = 0; i < n && !(seen[0] && seen[1]); i++) {
+      if (has_nulls && ArrowArrayViewIsNull(array_view, i)) {
+        continue;
       }
-    } else if constexpr (std::is_same_v<T, StringArray>) {
-      const struct ArrowStringView sv {
-        val.data(), static_cast<int64_t>(val.size())
-      };
-      if (ArrowArrayAppendString(result.get(), sv)) {
-        throw std::runtime_error("failed to append string!");
+      const auto value = ArrowBitGet(data, offset + i);
+      if (!seen[value]) {
+        seen[value] = true;
+        positions.push_back(i);
       }
-    } else {
-      // see https://stackoverflow.com/a/64354296/621736
-      static_assert(!sizeof(T), "Unique not implemented for type");
     }
-  }
+    return true;
+  } else if constexpr (std::is_same_v<T, Int64Array>) {
+    const auto min = MinMaxInternal<T, true>(self, true);
+    const auto max = MinMaxInternal<T, false>(self, true);
+    if (!min) {
+      return true; // empty or all null
+    }
 
-  struct ArrowError error;
-  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
-    throw std::runtime_error("Failed to finish building: " +
-                             std::string(error.message));
+    const uint64_t range =
+        static_cast<uint64_t>(*max) - static_cast<uint64_t>(*min);
+    if (range >= static_cast<uint64_t>(std::min(n, kMaxDirectIndexRange))) {
+      return false;
+    }
+
+    const int64_t *values = array_view->buffer_views[1].data.as_int64 + offset;
+    std::vector<bool> seen(range + 1, false);
+    for (int64_t i = 0; i < n; i++) {
+      if (has_nulls && ArrowArrayViewIsNull(array_view, i)) {
+        continue;
+      }
+      const auto slot = static_cast<uint64_t>(values[i]) -
+                        static_cast<uint64_t>(*min);
+      if (!seen[slot]) {
+        seen[slot] = true;
+        positions.push_back(i);
+      }
+    }
+    return true;
+  } else {
+    return false;
   }
+}
 
-  return T(std::move(result));
+// Returns distinct values in order of first appearance like pandas, or
+// sorted if requested
+template <typename T> T Unique(const T &self, bool sort) {
+  const int64_t n = self.array_view_->length;
+  std::vector<int64_t> positions;
+  if (!DirectIndexedPositions(self, positions)) {
+    positions = DistinctPositions(self, std::min(n, kDefaultSizeHint), nullptr);
+  }
+
+  if (sort) {
+    const struct ArrowArrayView *array_view = self.array_view_.get();
+    std::sort(positions.begin(), positions.end(),
+              [&self, array_view](int64_t left, int64_t right) {
+                if constexpr (std::is_same_v<T, StringViewArray>) {
+                  return self.Value(left) < self.Value(right);
+                } else if constexpr (std::is_same_v<T, StringArray>) {
+                  const auto lhs = T::ArrowGetFunc(array_view, left);
+                  const auto rhs = T::ArrowGetFunc(array_view, right);
+                  const auto lhs_size = static_cast<size_t>(lhs.size_bytes);
+                  const auto rhs_size = static_cast<size_t>(rhs.size_bytes);
+                  return std::string_view{lhs.data, lhs_size} <
+                         std::string_view{rhs.data, rhs_size};
+                } else {
+                  return T::ArrowGetFunc(array_view, left) <
+                         T::ArrowGetFunc(array_view, right);
+                }
+              });
+  }
+
+  return TakeInternal(self, positions.data(),
+                      static_cast<int64_t>(positions.size()), false,
+                      std::nullopt);
 }
 
-template <typename T> std::tuple<Int64Array, T> Factorize(const T &self) {
-  std::unordered_map<typename T::ScalarT, int64_t> first_occurances;
+template <typename T>
+std::tuple<Int64Array, T> Factorize(const T &self,
+                                    std::optional<int64_t> size_hint) {
+  const int64_t n = self.array_view_->length;
 
-  nanoarrow::UniqueArray values;
-  if (ArrowArrayInitFromType(values.get(), T::ArrowT)) {
-    throw std::runtime_error("Unable to init array for values!");
-  }
   nanoarrow::UniqueArray locs;
   if (ArrowArrayInitFromType(locs.get(), NANOARROW_TYPE_INT64)) {
     throw std::runtime_error("Unable to init int64 array!");
   }
-  const auto n = self.array_view_->length;
-
-  if (ArrowArrayStartAppending(values.get())) {
-    throw std::runtime_error("Could not start appending");
+  struct ArrowBuffer *codes_buffer = ArrowArrayBuffer(locs.get(), 1);
+  if (ArrowBufferResize(codes_buffer, n * sizeof(int64_t), false)) {
+    throw std::runtime_error("Unable to allocate codes buffer!");
   }
 
-  if (ArrowArrayStartAppending(locs.get())) {
-    throw std::runtime_error("Could not start appending");
-  }
+  // the hint comes from Python and only presizes the table, which never
+  // needs more entries than there are rows
+  const int64_t hint = size_hint.has_value()
+                           ? std::clamp(*size_hint, int64_t{0}, n)
+                           : std::min(n, kDefaultSizeHint);
+  const auto positions = DistinctPositions(
+      self, hint, reinterpret_cast<int64_t *>(codes_buffer->data));
 
-  for (int64_t idx = 0; idx < n; idx++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), idx)) {
-      if (ArrowArrayAppendInt(locs.get(), -1)) {
-        throw std::runtime_error("failed to append int!");
-      }
-    } else {
-      const auto current_size = static_cast<int64_t>(first_occurances.size());
-
-      // TODO: we can make this generic and combine branches if we defined a
-      // hashing and comparison operator for the ArrowString types
-      if constexpr (std::is_same_v<T, BoolArray> ||
-                    std::is_same_v<T, Int64Array>) {
-        const auto value =
-            ArrowArrayViewGetIntUnsafe(self.array_view_.get(), idx);
-        auto did_insert = first_occurances.try_emplace(value, current_size);
-        if (did_insert.second) {
-          if (ArrowArrayAppendInt(locs.get(), current_size)) {
-            throw std::runtime_error("failed to append int!");
-          }
-          if (ArrowArrayAppendInt(values.get(), value)) {
-            throw std::runtime_error("failed to append string");
-          }
-        } else {
-          const int64_t existing_loc = did_insert.first->second;
-          if (ArrowArrayAppendInt(locs.get(), existing_loc)) {
-            throw std::runtime_error("failed to append int!");
-          }
-        }
-      } else if constexpr (std::is_same_v<T, StringArray>) {
-        const auto sv =
-            ArrowArrayViewGetStringUnsafe(self.array_view_.get(), idx);
-        const std::string_view value{sv.data,
-                                     static_cast<size_t>(sv.size_bytes)};
-
-        auto did_insert = first_occurances.try_emplace(value, current_size);
-        if (did_insert.second) {
-          if (ArrowArrayAppendInt(locs.get(), current_size)) {
-            throw std::runtime_error("failed to append int!");
-          }
-          if (ArrowArrayAppendString(values.get(), sv)) {
-            throw std::runtime_error("failed to append string");
-          }
-        } else {
-          const int64_t existing_loc = did_insert.first->second;
-          if (ArrowArrayAppendInt(locs.get(), existing_loc)) {
-            throw std::runtime_error("failed to append int!");
-          }
-        }
-      } else {
-        // see https://stackoverflow.com/a/64354296/621736
-        static_assert(!sizeof(T), "Factorize not implemented for type");
-      }
-    }
-  }
+  locs->length = n;
+  locs->null_count = 0;
 
   struct ArrowError error;
-  if (ArrowArrayFinishBuildingDefault(values.get(), &error)) {
-    throw std::runtime_error("Failed to finish building: " +
-                             std::string(error.message));
-  }
   if (ArrowArrayFinishBuildingDefault(locs.get(), &error)) {
     throw std::runtime_error("Failed to finish building: " +
                              std::string(error.message));
   }
 
-  return std::make_tuple(Int64Array{std::move(locs)}, T{std::move(values)});
-}
-
-template <typename T>
-std::vector<std::optional<typename T::ScalarT>> ToPyList(const T &self) {
-  const auto n = self.array_view_->length;
-  std::vector<std::optional<typename T::ScalarT>> result;
+  auto values = TakeInternal(self, positions.data(),
+                             static_cast<int64_t>(positions.size()), false,
+                             std::nullopt);
 
-  result.reserve(n);
-  for (int64_t i = 0; i < n; i++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), i)) {
-      result.push_back(std::nullopt);
-    } else {
-      if constexpr (std::is_same_v<T, BoolArray> ||
-                    std::is_same_v<T, Int64Array>) {
-        result.push_back(ArrowArrayViewGetIntUnsafe(self.array_view_.get(), i));
-      } else if constexpr (std::is_same_v<T, StringArray>) {
-        const auto sv =
-            ArrowArrayViewGetStringUnsafe(self.array_view_.get(), i);
-        const std::string_view value{sv.data,
-                                     static_cast<size_t>(sv.size_bytes)};
-        result.push_back(value);
-      } else {
-        // see https://stackoverflow.com/a/64354296/621736
-        static_assert(!sizeof(T), "to_pylist not implemented for type");
-      }
-    }
-  }
-
-  return result;
+  return std::make_tuple(Int64Array{std::move(locs)}, std::move(values));
 }
 
-template <typename T> T ConcatSameType(const T &self, const T &other) {
-  // this implementation assumes that you have a validity and a
-  // data buffer, but that is not enforced by compiler yet
-  // see also specializations in generic.cpp
+// Concatenates arrays into one contiguous array. Every buffer of the result
+// is allocated once at its final size and filled by copying whole ranges:
+// bitmaps are shifted into place a word at a time and string offsets are
+// rebased onto the data that precedes them. Bitmaps are copied serially, as
+// arrays rarely start on a word boundary of the output and morsels would
+// otherwise share words
+template <typename T> T Concatenate(const std::vector<const T *> &arrays) {
   nanoarrow::UniqueArray result;
   if (ArrowArrayInitFromType(result.get(), T::ArrowT)) {
-    throw std::runtime_error(
-        "Unable to init output array for _concat_same_type!");
+    throw std::runtime_error("Unable to init output array for concatenate!");
   }
 
-  // TODO: check for overflow
-  const auto n = self.array_view_->length + other.array_view_->length;
-
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
+  int64_t n = 0;
+  int64_t null_count = 0;
+  for (const auto array : arrays) {
+    n += array->array_view_->length;
+    null_count += array->GetNullCount();
   }
 
-  if (ArrowArrayReserve(result.get(), n)) {
-    throw std::runtime_error("Unable to reserve array!");
-  }
+  if (null_count > 0) {
+    // arrays without a validity bitmap keep the all valid fill
+    struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result.get());
+    if (ArrowBufferAppendFill(&bitmap->buffer, 0xff, _ArrowBytesForBits(n))) {
+      throw std::runtime_error("Unable to allocate validity bitmap!");
+    }
 
-  // TODO: would be great to have a more efficient memcpy based algorithm
-  // to combine the bitmasks
-  for (int64_t idx = 0; idx < self.array_view_.get()->length; idx++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), idx)) {
-      if (ArrowArrayAppendNull(result.get(), 1)) {
-        throw std::runtime_error("failed to append null!");
-      }
-    } else {
-      if (ArrowArrayAppendEmpty(result.get(), 1)) {
-        throw std::runtime_error("failed to append valid!");
+    int64_t position = 0;
+    for (const auto array : arrays) {
+      const struct ArrowArrayView *array_view = array->array_view_.get();
+      const uint8_t *validity = array_view->buffer_views[0].data.as_uint8;
+      if (validity != nullptr) {
+        CopyBitmap(validity, array_view->offset, bitmap->buffer.data, position,
+                   array_view->length);
       }
+      position += array_view->length;
     }
+    bitmap->size_bits = n;
   }
 
-  for (int64_t idx = 0; idx < other.array_view_.get()->length; idx++) {
-    if (ArrowArrayViewIsNull(other.array_view_.get(), idx)) {
-      if (ArrowArrayAppendNull(result.get(), 1)) {
-        throw std::runtime_error("failed to append null!");
-      }
-    } else {
-      if (ArrowArrayAppendEmpty(result.get(), 1)) {
-        throw std::runtime_error("failed to append valid!");
-      }
+  if constexpr (std::is_same_v<T, BoolArray>) {
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferAppendFill(data, 0, _ArrowBytesForBits(n))) {
+      throw std::runtime_error("Unable to allocate data buffer!");
     }
-  }
 
-  const struct ArrowBufferView left_buffer =
-      self.array_view_.get()->buffer_views[1];
-  const struct ArrowBufferView right_buffer =
-      other.array_view_.get()->buffer_views[1];
+    int64_t position = 0;
+    for (const auto array : arrays) {
+      const struct ArrowArrayView *array_view = array->array_view_.get();
+      CopyBitmap(array_view->buffer_views[1].data.as_uint8, array_view->offset,
+                 data->data, position, array_view->length);
+      position += array_view->length;
+    }
+  } else if constexpr (std::is_same_v<T, Int64Array>) {
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferResize(data, n * sizeof(int64_t), false)) {
+      throw std::runtime_error("Unable to allocate data buffer!");
+    }
+
+    auto out = reinterpret_cast<int64_t *>(data->data);
+    for (const auto array : arrays) {
+      const struct ArrowArrayView *array_view = array->array_view_.get();
+      const int64_t *values =
+          array_view->buffer_views[1].data.as_int64 + array_view->offset;
+      ParallelFor(array_view->length, [&](int64_t begin, int64_t end) {
+        std::memcpy(out + begin, values + begin,
+                    (end - begin) * sizeof(int64_t));
+      });
+      out += array_view->length;
+    }
+  } else if constexpr (std::is_same_v<T, StringArray>) {
+    int64_t nbytes = 0;
+    for (const auto array : arrays) {
+      const struct ArrowArrayView *array_view = array->array_view_.get();
+      const int64_t *offsets =
+          array_view->buffer_views[1].data.as_int64 + array_view->offset;
+      nbytes += offsets[array_view->length] - offsets[0];
+    }
+
+    struct ArrowBuffer *offsets_buffer = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferResize(offsets_buffer, (n + 1) * sizeof(int64_t), false)) {
+      throw std::runtime_error("Unable to allocate offsets buffer!");
+    }
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 2);
+    if (ArrowBufferResize(data, nbytes, false)) {
+      throw std::runtime_error("Unable to allocate data buffer!");
+    }
 
-  const struct ArrowBuffer *result_buffer =
-      ArrowArrayBuffer(const_cast<struct ArrowArray *>(result.get()), 1);
+    auto out_offsets = reinterpret_cast<int64_t *>(offsets_buffer->data);
+    out_offsets[0] = 0;
+    int64_t position = 0;
+    int64_t data_position = 0;
+    for (const auto array : arrays) {
+      const struct ArrowArrayView *array_view = array->array_view_.get();
+      const int64_t length = array_view->length;
+      const int64_t *offsets =
+          array_view->buffer_views[1].data.as_int64 + array_view->offset;
+      const int64_t delta = data_position - offsets[0];
+      int64_t *dst = out_offsets + position + 1;
+      ParallelFor(length, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          dst[i] = offsets[i + 1] + delta;
+        }
+      });
 
-  const int64_t left_nbytes = left_buffer.size_bytes;
-  const int64_t right_nbytes = right_buffer.size_bytes;
+      const int64_t array_nbytes = offsets[length] - offsets[0];
+      if (array_nbytes > 0) {
+        std::memcpy(data->data + data_position,
+                    array_view->buffer_views[2].data.as_char + offsets[0],
+                    array_nbytes);
+      }
+      position += length;
+      data_position += array_nbytes;
+    }
+  } else {
+    // see https://stackoverflow.com/a/64354296/621736
+    static_assert(!sizeof(T), "concatenate not implemented for type");
+  }
 
-  std::memcpy(result_buffer->data, left_buffer.data.as_uint8, left_nbytes);
-  std::memcpy(result_buffer->data + left_nbytes, right_buffer.data.as_uint8,
-              right_nbytes);
+  result->length = n;
+  result->null_count = null_count;
 
   struct ArrowError error;
   if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
@@ -1023,8 +1263,26 @@ template <typename T> T ConcatSameType(const T &self, const T &other) {
   return T(std::move(result));
 }
 
-template <>
-BoolArray ConcatSameType(const BoolArray &self, const BoolArray &other);
+// Bound as a method taking either one array or a sequence of them, so that
+// both arr._concat_same_type(other) and the classmethod style call pandas
+// makes, cls._concat_same_type(to_concat), work. In the latter the sequence
+// is passed in place of self
+template <typename T> T ConcatSameType(nb::handle self, nb::handle to_concat) {
+  std::vector<const T *> arrays;
+  const auto append = [&arrays](nb::handle obj) {
+    if (nb::isinstance<T>(obj)) {
+      arrays.push_back(&nb::cast<const T &>(obj));
+    } else {
+      const auto sequence = nb::cast<std::vector<const T *>>(obj);
+      arrays.insert(arrays.end(), sequence.begin(), sequence.end());
+    }
+  };
+
+  append(self);
+  if (!to_concat.is_none()) {
+    append(to_concat);
+  }
 
-template <>
-StringArray ConcatSameType(const StringArray &self, const StringArray &other);
+  nb::gil_scoped_release release;
+  return Concatenate(arrays);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// finalizer from MurmurHash3; being a bijection on 64 bit integers, equal
+// hashes of integer keys imply equal keys
+inline uint64_t MixHash(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+inline uint64_t HashBytes(const char *data, int64_t nbytes) {
+  uint64_t h = 0x9e3779b97f4a7c15ULL ^ static_cast<uint64_t>(nbytes);
+  int64_t i = 0;
+  for (; i + 8 <= nbytes; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    h = MixHash(h ^ word);
+  }
+
+  if (i < nbytes) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, static_cast<size_t>(nbytes - i));
+    h = MixHash(h ^ word);
+  }
+
+  return MixHash(h);
+}
+
+// Flat, linearly probed table that assigns dense ids (in order of first
+// insertion) to distinct values. Slots only hold the full hash and the id;
+// the values themselves stay in the source array and are compared through
+// a callback, so inserts never allocate per value
+class HashTable {
+public:
+  explicit HashTable(int64_t size_hint) {
+    // at least twice the hint, found without ever computing size_hint * 2 or
+    // shifting capacity past the largest power of two an int64_t can hold
+    constexpr int64_t kMaxInitialCapacity = int64_t{1} << 62;
+    int64_t capacity = 16;
+    while ((capacity / 2 < size_hint) && (capacity < kMaxInitialCapacity)) {
+      capacity <<= 1;
+    }
+    slots_.assign(capacity, Slot{0, kEmpty});
+  }
+
+  int64_t size() const { return size_; }
+
+  // Returns the id for the value with the given hash and whether it was
+  // newly inserted. is_equal(id) is only invoked for slots whose stored hash
+  // matches; callers hashing with MixHash on integers can always return true
+  template <typename EqualFunc>
+  std::pair<int64_t, bool> FindOrInsert(uint64_t hash, EqualFunc &&is_equal) {
+    const auto mask = slots_.size() - 1;
+    auto pos = hash & mask;
+    while (true) {
+      Slot &slot = slots_[pos];
+      if (slot.id == kEmpty) {
+        const int64_t id = size_++;
+        slot = Slot{hash, id};
+        if (size_ * 2 > static_cast<int64_t>(slots_.size())) {
+          Grow();
+        }
+        return {id, true};
+      }
+
+      if ((slot.hash == hash) && is_equal(slot.id)) {
+        return {slot.id, false};
+      }
+
+      pos = (pos + 1) & mask;
+    }
+  }
+
+private:
+  static constexpr int64_t kEmpty = -1;
+
+  struct Slot {
+    uint64_t hash;
+    int64_t id;
+  };
+
+  // stored hashes mean growing never has to look at the values again
+  void Grow() {
+    std::vector<Slot> old_slots(slots_.size() * 2, Slot{0, kEmpty});
+    old_slots.swap(slots_);
+
+    const auto mask = slots_.size() - 1;
+    for (const auto &slot : old_slots) {
+      if (slot.id == kEmpty) {
+        continue;
+      }
+      auto pos = slot.hash & mask;
+      while (slots_[pos].id != kEmpty) {
+        pos = (pos + 1) & mask;
+      }
+      slots_[pos] = slot;
+    }
+  }
+
+  std::vector<Slot> slots_;
+  int64_t size_ = 0;
+};
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../array_types.hpp"
+#include "bitmap.hpp"
+#include "generic.hpp"
+#include "parallel.hpp"
+
+// Kleene logical operators, applied to 64 rows at once. Each side is given
+// as its validity and data words and the operator computes the validity and
+// data words of the result. A null side is treated as unknown, so e.g.
+// False & NA is False and True | NA is True. Data bits behind nulls are
+// arbitrary, which the formulas below do not depend on
+struct LogicalAnd {
+  static void Apply(uint64_t left_valid, uint64_t left_data,
+                    uint64_t right_valid, uint64_t right_data,
+                    uint64_t &valid, uint64_t &data) {
+    // known when both sides are, or when either side is a known false
+    valid = (left_valid & right_valid) | (left_valid & ~left_data) |
+            (right_valid & ~right_data);
+    data = left_data & right_data;
+  }
+};
+
+struct LogicalOr {
+  static void Apply(uint64_t left_valid, uint64_t left_data,
+                    uint64_t right_valid, uint64_t right_data,
+                    uint64_t &valid, uint64_t &data) {
+    // known when both sides are, or when either side is a known true
+    valid = (left_valid & right_valid) | (left_valid & left_data) |
+            (right_valid & right_data);
+    data = left_data | right_data;
+  }
+};
+
+struct LogicalXor {
+  static void Apply(uint64_t left_valid, uint64_t left_data,
+                    uint64_t right_valid, uint64_t right_data,
+                    uint64_t &valid, uint64_t &data) {
+    valid = left_valid & right_valid;
+    data = left_data ^ right_data;
+  }
+};
+
+// Combines self with either another BoolArray of the same length or a scalar
+// broadcast over every row, where a missing scalar stands for NA
+template <typename Op>
+BoolArray LogicalInternal(const BoolArray &self, const BoolArray *right_array,
+                          const std::optional<bool> &right_scalar) {
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_BOOL)) {
+    throw std::runtime_error("Unable to init bool array!");
+  }
+
+  const struct ArrowArrayView *left = self.array_view_.get();
+  const struct ArrowArrayView *right =
+      right_array != nullptr ? right_array->array_view_.get() : nullptr;
+  const auto n = left->length;
+  if ((right != nullptr) && (n != right->length)) {
+    throw std::range_error("Arrays are not of equal size");
+  }
+
+  const bool left_has_nulls = self.GetNullCount() > 0;
+  const bool right_has_nulls = right_array != nullptr
+                                   ? right_array->GetNullCount() > 0
+                                   : !right_scalar.has_value();
+
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferResize(data, _ArrowBytesForBits(n), false)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+
+  // without nulls on either side every row of the result is known too, so
+  // no validity bitmap needs to be written
+  struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result.get());
+  uint8_t *validity = nullptr;
+  if (left_has_nulls || right_has_nulls) {
+    if (ArrowBufferResize(&bitmap->buffer, _ArrowBytesForBits(n), false)) {
+      throw std::runtime_error("Unable to allocate validity bitmap!");
+    }
+    bitmap->size_bits = n;
+    validity = bitmap->buffer.data;
+  }
+
+  const auto load = [](const struct ArrowArrayView *view, int buffer,
+                       bool has_bits, int64_t i, int64_t nbits) {
+    return has_bits ? LoadBitmapWord(view->buffer_views[buffer].data.as_uint8,
+                                     view->offset + i, nbits)
+                    : ~uint64_t{0};
+  };
+  const uint64_t scalar_valid = right_scalar.has_value() ? ~uint64_t{0} : 0;
+  const uint64_t scalar_data = right_scalar.value_or(false) ? ~uint64_t{0} : 0;
+
+  std::vector<int64_t> valid_counts(MorselCount(n));
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i += 64) {
+      const int64_t nbits = std::min<int64_t>(64, end - i);
+      const uint64_t left_valid = load(left, 0, left_has_nulls, i, nbits);
+      const uint64_t left_data = load(left, 1, true, i, nbits);
+      const uint64_t right_valid =
+          right == nullptr ? scalar_valid
+                           : load(right, 0, right_has_nulls, i, nbits);
+      const uint64_t right_data =
+          right == nullptr ? scalar_data : load(right, 1, true, i, nbits);
+
+      uint64_t valid_word;
+      uint64_t data_word;
+      Op::Apply(left_valid, left_data, right_valid, right_data, valid_word,
+                data_word);
+
+      const auto nbytes = static_cast<size_t>((nbits + 7) / 8);
+      if (nbits < 64) {
+        const uint64_t mask = (uint64_t{1} << nbits) - 1;
+        valid_word &= mask;
+        data_word &= mask;
+      }
+      std::memcpy(data->data + i / 8, &data_word, nbytes);
+      if (validity != nullptr) {
+        std::memcpy(validity + i / 8, &valid_word, nbytes);
+        valid_counts[i / kMorselSize] += PopCount(valid_word);
+      }
+    }
+  });
+
+  int64_t null_count = 0;
+  if (validity != nullptr) {
+    null_count = n;
+    for (const auto count : valid_counts) {
+      null_count -= count;
+    }
+  }
+
+  result->length = n;
+  result->null_count = null_count;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return BoolArray(std::move(result));
+}
+
+template <typename Op, typename T> T Logical(const T &self, const T &other) {
+  static_assert(std::is_same_v<T, BoolArray>,
+                "logical operators are only implemented for BoolArray");
+  return LogicalInternal<Op>(self, &other, std::nullopt);
+}
+
+template <typename Op, typename T>
+T LogicalScalar(const T &self, std::optional<bool> other) {
+  static_assert(std::is_same_v<T, BoolArray>,
+                "logical operators are only implemented for BoolArray");
+  return LogicalInternal<Op>(self, nullptr, other);
+}
+
+template <typename T> T InvertDunder(const T &self) {
+  static_assert(std::is_same_v<T, BoolArray>,
+                "__invert__ is only implemented for BoolArray");
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_BOOL)) {
+    throw std::runtime_error("Unable to init bool array!");
+  }
+
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const auto n = array_view->length;
+  const auto offset = array_view->offset;
+  const auto null_count = self.GetNullCount();
+  const int64_t bytes_required = _ArrowBytesForBits(n);
+
+  if (null_count > 0) {
+    struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result.get());
+    if (ArrowBufferAppendFill(&bitmap->buffer, 0, bytes_required)) {
+      throw std::runtime_error("Unable to allocate validity bitmap!");
+    }
+    CopyBitmap(array_view->buffer_views[0].data.as_uint8, offset,
+               bitmap->buffer.data, 0, n);
+    bitmap->size_bits = n;
+  }
+
+  // the data is shifted to start at bit zero first, after which whole
+  // bytes can be inverted; bits past the end are padding
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferAppendFill(data, 0, bytes_required)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+  CopyBitmap(array_view->buffer_views[1].data.as_uint8, offset, data->data, 0,
+             n);
+  if (InvertInplace(data->data, bytes_required)) {
+    throw std::runtime_error("Unexpected error with InvertInplace");
+  }
+
+  result->length = n;
+  result->null_count = null_count;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return BoolArray(std::move(result));
+}
@@ -1,65 +1,207 @@
+#pragma once
+
+#include <algorithm>
 #include <limits>
 #include <optional>
+#include <stdexcept>
 #include <stdint.h>
+#include <vector>
 
-template <typename T> std::optional<typename T::ScalarT> Sum(const T &self) {
-  const auto n = self.array_view_->length;
-  if ((n == 0) || (self.array_view_->null_count == n)) {
-    return std::nullopt;
+#include "bitmap.hpp"
+#include "parallel.hpp"
+
+// Walks elements [begin, end) of the int64 data buffer of self with no
+// per-element null checks; begin must be a multiple of 64. Runs of fully
+// valid 64-element blocks are handed to dense_func(values, n) and partially
+// valid blocks to masked_func(values, n, validity_word), so both can be
+// written as straight loops that the compiler will vectorize
+template <typename T, typename DenseFunc, typename MaskedFunc>
+void VisitInt64Blocks(const T &self, int64_t begin, int64_t end,
+                      DenseFunc &&dense_func, MaskedFunc &&masked_func) {
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const int64_t offset = array_view->offset;
+  const int64_t *values = array_view->buffer_views[1].data.as_int64 + offset;
+
+  if (self.GetNullCount() == 0) {
+    dense_func(values + begin, end - begin);
+    return;
   }
 
-  typename T::ScalarT result = 0;
-  for (int64_t i = 0; i < n; i++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), i)) {
+  const uint8_t *validity = array_view->buffer_views[0].data.as_uint8;
+  int64_t run_start = begin;
+  for (int64_t i = begin; i < end; i += 64) {
+    const int64_t block = std::min<int64_t>(64, end - i);
+    const uint64_t word = LoadBitmapWord(validity, offset + i, block);
+    const uint64_t all_valid =
+        block == 64 ? ~uint64_t{0} : (uint64_t{1} << block) - 1;
+    if (word == all_valid) {
       continue;
-    } else {
-      result += ArrowArrayViewGetIntUnsafe(self.array_view_.get(), i);
     }
+
+    if (run_start < i) {
+      dense_func(values + run_start, i - run_start);
+    }
+    if (word != 0) {
+      masked_func(values + i, block, word);
+    }
+    run_start = i + block;
   }
 
-  return result;
+  if (run_start < end) {
+    dense_func(values + run_start, end - run_start);
+  }
 }
 
-template <typename T> std::optional<typename T::ScalarT> Min(const T &self) {
+// 128 bit accumulator, so that overflow can be detected once at the end
+// instead of being checked on every addition
+struct CheckedInt64Sum {
+  uint64_t lo = 0;
+  int64_t hi = 0;
+
+  void Add(int64_t value) {
+    const uint64_t prev = lo;
+    lo += static_cast<uint64_t>(value);
+    hi += static_cast<int64_t>(lo < prev) + (value >> 63);
+  }
+
+  void Merge(const CheckedInt64Sum &other) {
+    const uint64_t prev = lo;
+    lo += other.lo;
+    hi += other.hi + static_cast<int64_t>(lo < prev);
+  }
+
+  bool Fits() const { return hi == (static_cast<int64_t>(lo) >> 63); }
+};
+
+// Sums the valid values of self into a 128 bit accumulator, leaving it to
+// the caller to check whether the total fits into an int64
+template <typename T> CheckedInt64Sum SumInternal(const T &self) {
   const auto n = self.array_view_->length;
-  if ((n == 0) || (self.array_view_->null_count == n)) {
+  // each morsel sums into its own accumulator; they are merged in order
+  // afterwards, which is exact as the accumulators cannot overflow
+  std::vector<CheckedInt64Sum> partials(MorselCount(n));
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    CheckedInt64Sum &total = partials[begin / kMorselSize];
+    const auto dense = [&total](const int64_t *values, int64_t len) {
+      CheckedInt64Sum acc[4];
+      int64_t i = 0;
+      for (; i + 4 <= len; i += 4) {
+        acc[0].Add(values[i]);
+        acc[1].Add(values[i + 1]);
+        acc[2].Add(values[i + 2]);
+        acc[3].Add(values[i + 3]);
+      }
+      for (; i < len; i++) {
+        acc[0].Add(values[i]);
+      }
+
+      for (const auto &partial : acc) {
+        total.Merge(partial);
+      }
+    };
+
+    const auto masked = [&total](const int64_t *values, int64_t len,
+                                 uint64_t word) {
+      CheckedInt64Sum acc;
+      for (int64_t i = 0; i < len; i++) {
+        const auto mask = -static_cast<int64_t>((word >> i) & 1);
+        acc.Add(values[i] & mask);
+      }
+      total.Merge(acc);
+    };
+
+    VisitInt64Blocks(self, begin, end, dense, masked);
+  });
+
+  CheckedInt64Sum total;
+  for (const auto &partial : partials) {
+    total.Merge(partial);
+  }
+
+  return total;
+}
+
+template <typename T>
+std::optional<typename T::ScalarT> Sum(const T &self, bool skipna,
+                                       int64_t min_count) {
+  const auto n = self.array_view_->length;
+  const auto null_count = self.GetNullCount();
+  if ((!skipna && null_count > 0) || (n - null_count < min_count)) {
     return std::nullopt;
   }
 
-  typename T::ScalarT result = std::numeric_limits<typename T::ScalarT>::max();
-  for (int64_t i = 0; i < n; i++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), i)) {
-      continue;
-    } else {
-      const int64_t value =
-          ArrowArrayViewGetIntUnsafe(self.array_view_.get(), i);
-      if (value < result) {
-        result = value;
-      }
-    }
+  const auto total = SumInternal(self);
+  if (!total.Fits()) {
+    throw std::overflow_error("int64 overflow in sum");
   }
 
-  return result;
+  return static_cast<int64_t>(total.lo);
 }
 
-template <typename T> std::optional<typename T::ScalarT> Max(const T &self) {
+template <typename T, bool IsMin>
+std::optional<typename T::ScalarT> MinMaxInternal(const T &self, bool skipna) {
   const auto n = self.array_view_->length;
-  if ((n == 0) || (self.array_view_->null_count == n)) {
+  const auto null_count = self.GetNullCount();
+  if ((n == 0) || (null_count == n) || (!skipna && null_count > 0)) {
     return std::nullopt;
   }
 
-  typename T::ScalarT result = std::numeric_limits<typename T::ScalarT>::min();
-  for (int64_t i = 0; i < n; i++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), i)) {
-      continue;
+  using ScalarT = typename T::ScalarT;
+  constexpr ScalarT identity = IsMin ? std::numeric_limits<ScalarT>::max()
+                                     : std::numeric_limits<ScalarT>::min();
+  const auto pick = [](ScalarT a, ScalarT b) {
+    if constexpr (IsMin) {
+      return a < b ? a : b;
     } else {
-      const int64_t value =
-          ArrowArrayViewGetIntUnsafe(self.array_view_.get(), i);
-      if (value > result) {
-        result = value;
-      }
+      return a > b ? a : b;
     }
+  };
+
+  std::vector<ScalarT> partials(MorselCount(n), identity);
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    ScalarT &result = partials[begin / kMorselSize];
+    const auto dense = [&](const int64_t *values, int64_t len) {
+      ScalarT acc[4] = {identity, identity, identity, identity};
+      int64_t i = 0;
+      for (; i + 4 <= len; i += 4) {
+        acc[0] = pick(acc[0], values[i]);
+        acc[1] = pick(acc[1], values[i + 1]);
+        acc[2] = pick(acc[2], values[i + 2]);
+        acc[3] = pick(acc[3], values[i + 3]);
+      }
+      for (; i < len; i++) {
+        acc[0] = pick(acc[0], values[i]);
+      }
+
+      result = pick(result, pick(pick(acc[0], acc[1]), pick(acc[2], acc[3])));
+    };
+
+    const auto masked = [&](const int64_t *values, int64_t len,
+                            uint64_t word) {
+      ScalarT acc = identity;
+      for (int64_t i = 0; i < len; i++) {
+        acc = pick(acc, ((word >> i) & 1) ? values[i] : identity);
+      }
+      result = pick(result, acc);
+    };
+
+    VisitInt64Blocks(self, begin, end, dense, masked);
+  });
+
+  ScalarT result = identity;
+  for (const auto partial : partials) {
+    result = pick(result, partial);
   }
 
   return result;
 }
+
+template <typename T>
+std::optional<typename T::ScalarT> Min(const T &self, bool skipna) {
+  return MinMaxInternal<T, true>(self, skipna);
+}
+
+template <typename T>
+std::optional<typename T::ScalarT> Max(const T &self, bool skipna) {
+  return MinMaxInternal<T, false>(self, skipna);
+}
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
+
+#include "../array_types.hpp"
+#include "bitmap.hpp"
+#include "compare.hpp"
+#include "parallel.hpp"
+
+namespace nb = nanobind;
+
+// Wraps a heap allocated buffer of n values as a writable numpy array that
+// frees the buffer once numpy is done with it
+template <typename V> nb::object OwnedNumpyArray(V *values, int64_t n) {
+  nb::capsule owner(values, [](void *p) noexcept {
+    delete[] static_cast<V *>(p);
+  });
+  return nb::cast(nb::ndarray<nb::numpy, V, nb::ndim<1>>(
+      values, {static_cast<size_t>(n)}, owner));
+}
+
+// Copies the values of self into a new numpy array, writing na_value into
+// the rows that are null
+template <typename T>
+nb::object NumpyCopy(const T &self, typename T::ScalarT na_value) {
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const auto n = array_view->length;
+  const auto offset = array_view->offset;
+  const uint8_t *validity = self.GetNullCount() > 0
+                                ? array_view->buffer_views[0].data.as_uint8
+                                : nullptr;
+
+  auto out = new typename T::ScalarT[n];
+  {
+    nb::gil_scoped_release release;
+    ParallelFor(n, [&](int64_t begin, int64_t end) {
+      if constexpr (std::is_same_v<T, BoolArray>) {
+        const uint8_t *values = array_view->buffer_views[1].data.as_uint8;
+        for (int64_t i = begin; i < end; i++) {
+          out[i] = ArrowBitGet(values, offset + i);
+        }
+      } else if constexpr (std::is_same_v<T, Int64Array>) {
+        std::memcpy(out + begin,
+                    array_view->buffer_views[1].data.as_int64 + offset + begin,
+                    (end - begin) * sizeof(int64_t));
+      } else {
+        // see https://stackoverflow.com/a/64354296/621736
+        static_assert(!sizeof(T), "to_numpy not implemented for type");
+      }
+
+      if (validity != nullptr) {
+        for (int64_t i = begin; i < end; i++) {
+          out[i] = ArrowBitGet(validity, offset + i) ? out[i] : na_value;
+        }
+      }
+    });
+  }
+
+  return OwnedNumpyArray(out, n);
+}
+
+// Returns a read-only numpy array that aliases the data buffer of self. The
+// capsule owning it holds a shared reference to the buffers, so the numpy
+// array stays valid after self is gone
+template <typename T> nb::object NumpyView(const T &self) {
+  static_assert(std::is_same_v<T, Int64Array>,
+                "only int64 data can be viewed without copying");
+  auto shared = new nanoarrow::UniqueArray();
+  self.ShareArray(shared->get());
+  nb::capsule owner(shared, [](void *p) noexcept {
+    delete static_cast<nanoarrow::UniqueArray *>(p);
+  });
+
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const int64_t *values =
+      array_view->buffer_views[1].data.as_int64 + array_view->offset;
+  return nb::cast(nb::ndarray<nb::numpy, const int64_t, nb::ndim<1>>(
+      const_cast<int64_t *>(values),
+      {static_cast<size_t>(array_view->length)}, owner));
+}
+
+// Returns the values together with a boolean mask that is true where a row
+// is missing, like the _data and _mask of pandas' masked arrays. Values
+// behind a missing row are unspecified
+template <typename T>
+std::tuple<nb::object, nb::object> ToNumpyMasked(const T &self) {
+  nb::object values;
+  if constexpr (std::is_same_v<T, Int64Array>) {
+    values = NumpyView(self);
+  } else {
+    values = NumpyCopy(self, typename T::ScalarT{});
+  }
+
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const auto n = array_view->length;
+  const auto offset = array_view->offset;
+  const uint8_t *validity = self.GetNullCount() > 0
+                                ? array_view->buffer_views[0].data.as_uint8
+                                : nullptr;
+  auto mask = new bool[n];
+  {
+    nb::gil_scoped_release release;
+    ParallelFor(n, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        mask[i] = validity != nullptr && !ArrowBitGet(validity, offset + i);
+      }
+    });
+  }
+
+  return {values, OwnedNumpyArray(mask, n)};
+}
+
+// pandas passes its no_default sentinel rather than None when to_numpy is
+// called without an na_value. pandas is imported lazily, as the sentinel
+// cannot exist without it
+inline bool IsNoValue(nb::handle value) {
+  if (value.is_none()) {
+    return true;
+  }
+  PyObject *extensions = PyImport_ImportModule("pandas.api.extensions");
+  if (extensions == nullptr) {
+    PyErr_Clear();
+    return false;
+  }
+  const auto module = nb::steal<nb::object>(extensions);
+  return value.is(module.attr("no_default"));
+}
+
+// Casts a numpy array to dtype, which only copies if the dtype differs
+inline nb::object NumpyAsType(nb::object values, nb::handle dtype) {
+  if (dtype.is_none()) {
+    return values;
+  }
+  using namespace nb::literals;
+  return values.attr("astype")(dtype, "copy"_a = false);
+}
+
+// Converts an array with nulls whose na_value is not a ScalarT. Missing rows
+// become na_value or, when none is given, NaN for float dtypes and None for
+// object dtype, which is also what no dtype gives, like pandas' masked
+// arrays do
+template <typename T>
+nb::object NumpyFillMissing(const T &self, nb::handle dtype,
+                            nb::handle na_value) {
+  nb::object fill = nb::borrow<nb::object>(na_value);
+  const bool no_value = IsNoValue(na_value);
+  if (no_value && dtype.is_none()) {
+    fill = nb::none();
+  } else if (no_value) {
+    const nb::object numpy_dtype = nb::module_::import_("numpy").attr("dtype");
+    const char kind =
+        nb::borrow<nb::str>(numpy_dtype(dtype).attr("kind")).c_str()[0];
+    if (kind == 'f' || kind == 'c') {
+      fill = nb::float_(std::numeric_limits<double>::quiet_NaN());
+    } else if (kind == 'O') {
+      fill = nb::none();
+    } else {
+      throw std::invalid_argument(
+          "cannot convert an array with missing values to a numpy dtype that "
+          "cannot hold them without an na_value");
+    }
+  }
+
+  const auto [values, mask] = ToNumpyMasked(self);
+  const nb::object target =
+      dtype.is_none() ? nb::str("O") : nb::borrow<nb::object>(dtype);
+  nb::object result = values.attr("astype")(target);
+  result.attr("__setitem__")(mask, fill);
+  return result;
+}
+
+// Int64Array data without nulls is handed to numpy without a copy unless one
+// is requested or dtype differs. BoolArray data is bit packed, so it is
+// always unpacked into a new array. Arrays with nulls are filled with
+// na_value, or else become an object array holding None
+template <typename T>
+nb::object ToNumpy(const T &self, nb::handle dtype, bool copy,
+                   nb::handle na_value) {
+  if (self.GetNullCount() == 0) {
+    if constexpr (std::is_same_v<T, Int64Array>) {
+      if (!copy) {
+        return NumpyAsType(NumpyView(self), dtype);
+      }
+    }
+    return NumpyAsType(NumpyCopy(self, typename T::ScalarT{}), dtype);
+  }
+
+  typename T::ScalarT fill{};
+  if (!IsNoValue(na_value) && nb::try_cast(na_value, fill)) {
+    return NumpyAsType(NumpyCopy(self, fill), dtype);
+  }
+  return NumpyFillMissing(self, dtype, na_value);
+}
+
+// Implements the numpy __array__ protocol. copy=None copies only if needed
+// and copy=True always does. copy=False raises when a copy cannot be avoided,
+// which is the case for bit packed BoolArray data, arrays with missing
+// values and conversions to another dtype
+template <typename T>
+nb::object ArrayDunder(const T &self, nb::handle dtype,
+                       std::optional<bool> copy) {
+  if (copy == false) {
+    if constexpr (std::is_same_v<T, Int64Array>) {
+      if (self.GetNullCount() == 0) {
+        nb::object result = NumpyView(self);
+        if (dtype.is_none() || result.attr("dtype").equal(dtype)) {
+          return result;
+        }
+      }
+    }
+    throw std::invalid_argument(
+        std::string("unable to avoid a copy while converting a ") + T::Name +
+        " to numpy");
+  }
+
+  return ToNumpy(self, dtype, copy.value_or(false), nb::none());
+}
+
+// Drops the reference that an adopted Arrow buffer holds on the numpy array
+// it came from. Buffers may be released by kernels running without the GIL
+inline void ReleaseNumpyBuffer(struct ArrowBufferAllocator *allocator,
+                               [[maybe_unused]] uint8_t *ptr,
+                               [[maybe_unused]] int64_t size) {
+  nb::gil_scoped_acquire acquire;
+  nb::handle(static_cast<PyObject *>(allocator->private_data)).dec_ref();
+}
+
+// Builds an array from a one dimensional numpy array and an optional mask
+// that is true where a row is missing. Contiguous int64 data is adopted
+// without a copy and kept alive by the new array, so it must not be modified
+// afterwards. Anything else is copied in bulk
+template <typename T> T FromNumpy(nb::handle values, nb::handle mask) {
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), T::ArrowT)) {
+    throw std::runtime_error("Unable to init output array for from_numpy!");
+  }
+
+  int64_t n;
+  if constexpr (std::is_same_v<T, Int64Array>) {
+    nb::ndarray<const int64_t, nb::ndim<1>, nb::c_contig> array;
+    if (nb::try_cast(values, array, false)) {
+      n = static_cast<int64_t>(array.shape(0));
+      struct ArrowBuffer buffer;
+      ArrowBufferInit(&buffer);
+      if (ArrowBufferSetAllocator(
+              &buffer, ArrowBufferDeallocator(&ReleaseNumpyBuffer,
+                                              values.inc_ref().ptr()))) {
+        values.dec_ref();
+        throw std::runtime_error("Unable to set buffer deallocator!");
+      }
+      buffer.data = reinterpret_cast<uint8_t *>(
+          const_cast<int64_t *>(array.data()));
+      buffer.size_bytes = n * static_cast<int64_t>(sizeof(int64_t));
+      buffer.capacity_bytes = buffer.size_bytes;
+      if (ArrowArraySetBuffer(result.get(), 1, &buffer)) {
+        ArrowBufferReset(&buffer);
+        throw std::runtime_error("Unable to adopt numpy buffer!");
+      }
+    } else {
+      // strided or differently typed input is converted by nanobind
+      array = nb::cast<nb::ndarray<const int64_t, nb::ndim<1>, nb::c_contig>>(
+          values);
+      n = static_cast<int64_t>(array.shape(0));
+      struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+      if (ArrowBufferAppend(data, array.data(), n * sizeof(int64_t))) {
+        throw std::runtime_error("Unable to allocate data buffer!");
+      }
+    }
+  } else if constexpr (std::is_same_v<T, BoolArray>) {
+    const auto array =
+        nb::cast<nb::ndarray<const bool, nb::ndim<1>, nb::c_contig>>(values);
+    n = static_cast<int64_t>(array.shape(0));
+    const bool *src = array.data();
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferResize(data, _ArrowBytesForBits(n), false)) {
+      throw std::runtime_error("Unable to allocate data buffer!");
+    }
+
+    nb::gil_scoped_release release;
+    FillBitmapWords(data->data, n, [src](int64_t i, int64_t nbits) {
+      return PackWord(i, nbits, [src](int64_t j) { return src[j]; });
+    });
+  } else {
+    // see https://stackoverflow.com/a/64354296/621736
+    static_assert(!sizeof(T), "from_numpy not implemented for type");
+  }
+
+  int64_t null_count = 0;
+  if (!mask.is_none()) {
+    const auto missing =
+        nb::cast<nb::ndarray<const bool, nb::ndim<1>, nb::c_contig>>(mask);
+    if (static_cast<int64_t>(missing.shape(0)) != n) {
+      throw std::invalid_argument("mask must have the same length as values");
+    }
+
+    const bool *src = missing.data();
+    nb::gil_scoped_release release;
+    null_count = AndValidity(
+        result.get(), nullptr, nullptr, n, [src](int64_t i, int64_t nbits) {
+          return ~PackWord(i, nbits, [src](int64_t j) { return src[j]; });
+        });
+  }
+
+  result->length = n;
+  result->null_count = null_count;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return T(std::move(result));
+}
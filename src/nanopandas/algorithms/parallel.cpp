@@ -0,0 +1,187 @@
+#include "parallel.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+namespace {
+
+int64_t DefaultNumThreads() {
+  const auto hardware =
+      static_cast<int64_t>(std::thread::hardware_concurrency());
+  return hardware > 0 ? hardware : 1;
+}
+
+// set while a thread is processing morsels, so that kernels nested inside a
+// morsel run serially instead of submitting to the pool they are running on
+thread_local bool inside_job = false;
+
+// A job is a flat range of morsels. Rather than keeping per thread deques
+// and stealing from them, every thread claims the next unprocessed morsel
+// from a shared counter, which balances uneven morsels just as well for a
+// single flat loop
+struct Job {
+  const std::function<void(int64_t)> *task;
+  int64_t nmorsels;
+  std::atomic<int64_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  void Work() {
+    const bool was_inside_job = inside_job;
+    inside_job = true;
+    int64_t morsel;
+    while ((morsel = next.fetch_add(1)) < nmorsels) {
+      try {
+        (*task)(morsel);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        // stop handing out work; morsels already claimed still finish
+        next.store(nmorsels);
+      }
+    }
+    inside_job = was_inside_job;
+  }
+};
+
+class ThreadPool {
+public:
+  explicit ThreadPool(int64_t num_threads) {
+    // the caller of Run works too, so one fewer thread needs spawning
+    for (int64_t i = 1; i < num_threads; i++) {
+      workers_.emplace_back([this] { WorkerLoop(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void Run(Job &job) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = &job;
+      busy_ = static_cast<int64_t>(workers_.size());
+      generation_++;
+    }
+    wake_.notify_all();
+
+    job.Work();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+    job_ = nullptr;
+  }
+
+private:
+  void WorkerLoop() {
+    uint64_t seen = 0;
+    while (true) {
+      Job *job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&] { return shutdown_ || generation_ != seen; });
+        if (shutdown_) {
+          return;
+        }
+        seen = generation_;
+        job = job_;
+      }
+
+      job->Work();
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--busy_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  Job *job_ = nullptr;
+  int64_t busy_ = 0;
+  uint64_t generation_ = 0;
+  bool shutdown_ = false;
+};
+
+// Only one job runs on the pool at a time. Jobs submitted from another
+// Python thread while it is busy run serially on their calling thread
+// instead of waiting
+std::mutex pool_mutex;
+std::atomic<int64_t> num_threads{DefaultNumThreads()};
+
+// the pool is created on first use and only torn down when the number of
+// threads changes; it is deliberately leaked at exit, as joining threads
+// while the interpreter shuts down can deadlock
+ThreadPool *pool = nullptr;
+
+#ifndef _WIN32
+// Only the forking thread exists in a child process, so the pool's workers
+// are gone. The pool is leaked rather than joined, and pool_mutex, which
+// another thread may have held at the time of the fork, is recreated
+void ResetPoolInChild() {
+  pool = nullptr;
+  new (&pool_mutex) std::mutex();
+}
+
+[[maybe_unused]] const int fork_handler_registered =
+    pthread_atfork(nullptr, nullptr, &ResetPoolInChild);
+#endif
+
+} // namespace
+
+void SetNumThreads(int64_t value) {
+  if (value < 0) {
+    throw std::invalid_argument("number of threads must not be negative");
+  }
+
+  std::lock_guard<std::mutex> lock(pool_mutex);
+  num_threads = value == 0 ? DefaultNumThreads() : value;
+  delete pool;
+  pool = nullptr;
+}
+
+int64_t GetNumThreads() { return num_threads; }
+
+void RunMorsels(int64_t nmorsels, const std::function<void(int64_t)> &task) {
+  Job job;
+  job.task = &task;
+  job.nmorsels = nmorsels;
+
+  std::unique_lock<std::mutex> lock(pool_mutex, std::defer_lock);
+  if (!inside_job && num_threads > 1 && nmorsels > 1 && lock.try_lock()) {
+    if (pool == nullptr) {
+      pool = new ThreadPool(num_threads);
+    }
+    pool->Run(job);
+  } else {
+    job.Work();
+  }
+
+  if (job.error) {
+    std::rethrow_exception(job.error);
+  }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+// Kernels split their input into morsels of kMorselSize elements, which are
+// handed out to a pool of worker threads on demand. The size is a multiple
+// of 64 so that morsels never share a word of an output bitmap
+constexpr int64_t kMorselSize = 1 << 14;
+
+// inputs up to this many elements are not worth waking up the pool for
+constexpr int64_t kSerialCutoff = 1 << 15;
+
+static_assert(kMorselSize % 64 == 0, "morsels must align with bitmap words");
+
+// 0 resets to the number of hardware threads; 1 disables parallelism
+void SetNumThreads(int64_t num_threads);
+int64_t GetNumThreads();
+
+inline int64_t MorselCount(int64_t n) {
+  return (n + kMorselSize - 1) / kMorselSize;
+}
+
+// Runs task(morsel) once for every morsel in [0, nmorsels) across the pool,
+// with the calling thread taking part. Blocks until every morsel is done and
+// rethrows the first exception raised by any of them
+void RunMorsels(int64_t nmorsels, const std::function<void(int64_t)> &task);
+
+// Calls func(begin, end) for each morsel of [0, n). Morsel i always covers
+// [i * kMorselSize, (i + 1) * kMorselSize), so callers can index per morsel
+// state with begin / kMorselSize. Small inputs run serially on the caller
+template <typename Func> void ParallelFor(int64_t n, Func &&func) {
+  const int64_t nmorsels = MorselCount(n);
+  const auto run = [&](int64_t morsel) {
+    const int64_t begin = morsel * kMorselSize;
+    func(begin, std::min(n, begin + kMorselSize));
+  };
+
+  if (n <= kSerialCutoff || GetNumThreads() <= 1) {
+    for (int64_t morsel = 0; morsel < nmorsels; morsel++) {
+      run(morsel);
+    }
+    return;
+  }
+
+  RunMorsels(nmorsels, run);
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Python.h>
+#include <nanobind/nanobind.h>
+
+#include "../array_types.hpp"
+#include "../string_view_array.hpp"
+#include "ascii.hpp"
+#include "bitmap.hpp"
+#include "hashtable.hpp"
+
+namespace nb = nanobind;
+
+// Conversion between Python objects and arrays using the CPython API
+// directly, as going through nanobind casters costs a lookup and a
+// temporary per element. Everything in here must be called with the GIL held
+
+[[noreturn]] inline void ThrowInvalidItem(PyObject *item, int64_t position,
+                                          const char *expected) {
+  PyErr_Clear();
+  const std::string message = "expected " + std::string(expected) +
+                              " or None at position " +
+                              std::to_string(position) + ", got " +
+                              Py_TYPE(item)->tp_name;
+  throw nb::type_error(message.c_str());
+}
+
+// Returns the UTF-8 bytes of a str without copying them. Compact ASCII
+// strings, the common case, store exactly those bytes inline; anything else
+// is encoded once by CPython, which caches the result on the object
+inline std::string_view Utf8View(PyObject *item, int64_t position) {
+  if (!PyUnicode_Check(item)) {
+    ThrowInvalidItem(item, position, "str");
+  }
+
+  if (PyUnicode_IS_COMPACT_ASCII(item)) {
+    return {static_cast<const char *>(PyUnicode_DATA(item)),
+            static_cast<size_t>(PyUnicode_GET_LENGTH(item))};
+  }
+
+  Py_ssize_t size;
+  const char *data = PyUnicode_AsUTF8AndSize(item, &size);
+  if (data == nullptr) {
+    PyErr_Clear();
+    throw std::invalid_argument("str at position " + std::to_string(position) +
+                                " cannot be encoded as UTF-8");
+  }
+
+  return {data, static_cast<size_t>(size)};
+}
+
+// Calls row_func(i, item) for every element of items, with item set to
+// nullptr for the ones that are None, and writes the validity of the n
+// elements into validity a word at a time. Returns the null count
+template <typename RowFunc>
+int64_t VisitPyItems(PyObject *const *items, int64_t n, uint8_t *validity,
+                     RowFunc &&row_func) {
+  int64_t null_count = 0;
+  for (int64_t i = 0; i < n; i += 64) {
+    const int64_t nbits = std::min<int64_t>(64, n - i);
+    uint64_t word = 0;
+    for (int64_t j = 0; j < nbits; j++) {
+      PyObject *item = items[i + j];
+      const bool is_valid = item != Py_None;
+      word |= static_cast<uint64_t>(is_valid) << j;
+      row_func(i + j, is_valid ? item : nullptr);
+    }
+    null_count += nbits - PopCount(word);
+    std::memcpy(validity + i / 8, &word, static_cast<size_t>((nbits + 7) / 8));
+  }
+
+  return null_count;
+}
+
+// Builds an array from a list, tuple or any other iterable of Python
+// scalars and None. Lists and tuples are read in place and other iterables
+// are collected into a list first, so the length is always known and every
+// buffer is allocated once. Strings take two passes: the first computes the
+// offsets and the second copies the bytes
+template <typename T> T FromPySequence(nb::handle values) {
+  PyObject *fast = PySequence_Fast(values.ptr(), "expected a sequence");
+  if (fast == nullptr) {
+    throw nb::python_error();
+  }
+  const auto owner = nb::steal<nb::object>(fast);
+  const int64_t n = PySequence_Fast_GET_SIZE(fast);
+  PyObject *const *items = PySequence_Fast_ITEMS(fast);
+
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), T::ArrowT)) {
+    throw std::runtime_error("Unable to init output array for FromSequence!");
+  }
+
+  struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result.get());
+  if (ArrowBufferResize(&bitmap->buffer, _ArrowBytesForBits(n), false)) {
+    throw std::runtime_error("Unable to allocate validity bitmap!");
+  }
+  bitmap->size_bits = n;
+  uint8_t *validity = bitmap->buffer.data;
+
+  int64_t null_count;
+  if constexpr (std::is_same_v<T, BoolArray>) {
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferResize(data, _ArrowBytesForBits(n), false)) {
+      throw std::runtime_error("Unable to allocate data buffer!");
+    }
+    uint8_t *out = data->data;
+    null_count = VisitPyItems(items, n, validity, [&](int64_t i,
+                                                      PyObject *item) {
+      bool value = false;
+      if (item == Py_True) {
+        value = true;
+      } else if ((item != nullptr) && (item != Py_False) &&
+                 !nb::try_cast(nb::handle(item), value)) {
+        ThrowInvalidItem(item, i, "bool");
+      }
+      ArrowBitSetTo(out, i, value);
+    });
+  } else if constexpr (std::is_same_v<T, Int64Array>) {
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferResize(data, n * sizeof(int64_t), false)) {
+      throw std::runtime_error("Unable to allocate data buffer!");
+    }
+    auto out = reinterpret_cast<int64_t *>(data->data);
+    null_count = VisitPyItems(items, n, validity, [&](int64_t i,
+                                                      PyObject *item) {
+      if (item == nullptr) {
+        out[i] = 0;
+        return;
+      }
+      int overflow;
+      const long long value = PyLong_AsLongLongAndOverflow(item, &overflow);
+      if (overflow != 0) {
+        throw std::overflow_error("int at position " + std::to_string(i) +
+                                  " does not fit into int64");
+      }
+      if ((value == -1) && (PyErr_Occurred() != nullptr)) {
+        ThrowInvalidItem(item, i, "int");
+      }
+      out[i] = value;
+    });
+  } else if constexpr (std::is_same_v<T, StringArray>) {
+    struct ArrowBuffer *offsets_buffer = ArrowArrayBuffer(result.get(), 1);
+    if (ArrowBufferResize(offsets_buffer, (n + 1) * sizeof(int64_t), false)) {
+      throw std::runtime_error("Unable to allocate offsets buffer!");
+    }
+    auto offsets = reinterpret_cast<int64_t *>(offsets_buffer->data);
+    offsets[0] = 0;
+    null_count = VisitPyItems(items, n, validity, [&](int64_t i,
+                                                      PyObject *item) {
+      const int64_t size =
+          item == nullptr ? 0 : static_cast<int64_t>(Utf8View(item, i).size());
+      offsets[i + 1] = offsets[i] + size;
+    });
+
+    struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 2);
+    if (ArrowBufferResize(data, offsets[n], false)) {
+      throw std::runtime_error("Unable to allocate data buffer!");
+    }
+    for (int64_t i = 0; i < n; i++) {
+      if (items[i] != Py_None) {
+        const std::string_view value = Utf8View(items[i], i);
+        std::memcpy(data->data + offsets[i], value.data(), value.size());
+      }
+    }
+  } else {
+    // see https://stackoverflow.com/a/64354296/621736
+    static_assert(!sizeof(T), "FromSequence not implemented for type");
+  }
+
+  if (null_count == 0) {
+    ArrowBitmapReset(bitmap);
+  }
+
+  result->length = n;
+  result->null_count = null_count;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return T(std::move(result));
+}
+
+// Binds as __init__, so constructors accept any sequence without first
+// copying it into a std::vector
+template <typename T> void InitFromPySequence(T *self, nb::handle values) {
+  new (self) T(FromPySequence<T>(values));
+}
+
+// Returns a new reference to a str holding value. ASCII values are copied
+// straight into a str allocated for them; anything else is decoded
+inline PyObject *NewPyStr(std::string_view value) {
+  const auto size = static_cast<Py_ssize_t>(value.size());
+  PyObject *result;
+  if (IsAscii(value.data(), size)) {
+    result = PyUnicode_New(size, 127);
+    if (result != nullptr) {
+      std::memcpy(PyUnicode_DATA(result), value.data(), value.size());
+    }
+  } else {
+    result = PyUnicode_DecodeUTF8(value.data(), size, "strict");
+  }
+
+  if (result == nullptr) {
+    throw nb::python_error();
+  }
+
+  return result;
+}
+
+// Direct mapped cache of the str objects created for recently seen values,
+// so that a column with few distinct values creates one str per value
+// rather than one per row. Entries are borrowed, so the cache must not
+// outlive the objects it hands out nor the buffers the values point into.
+// Long values are not cached, as decoding them costs about as much as
+// hashing and comparing them
+class PyStrCache {
+public:
+  PyObject *Get(std::string_view value) {
+    if (value.size() > kMaxCachedBytes) {
+      return NewPyStr(value);
+    }
+
+    const uint64_t hash =
+        HashBytes(value.data(), static_cast<int64_t>(value.size()));
+    Entry &entry = entries_[hash & (kNumEntries - 1)];
+    if ((entry.object == nullptr) || (entry.value != value)) {
+      entry.object = NewPyStr(value);
+      entry.value = value;
+      return entry.object;
+    }
+
+    Py_INCREF(entry.object);
+    return entry.object;
+  }
+
+private:
+  static constexpr size_t kNumEntries = 1024;
+  static constexpr size_t kMaxCachedBytes = 64;
+
+  struct Entry {
+    std::string_view value;
+    PyObject *object = nullptr;
+  };
+
+  std::vector<Entry> entries_ = std::vector<Entry>(kNumEntries);
+};
+
+// Stores the elements of self into list, which must have room for them
+// starting at position start
+template <typename T>
+void FillPyList(const T &self, PyObject *list, int64_t start,
+                PyStrCache &cache) {
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const auto n = array_view->length;
+  const auto offset = array_view->offset;
+  const uint8_t *validity = self.GetNullCount() > 0
+                                ? array_view->buffer_views[0].data.as_uint8
+                                : nullptr;
+
+  for (int64_t i = 0; i < n; i++) {
+    PyObject *item;
+    if ((validity != nullptr) && !ArrowBitGet(validity, offset + i)) {
+      item = Py_None;
+      Py_INCREF(item);
+    } else if constexpr (std::is_same_v<T, BoolArray>) {
+      item = ArrowBitGet(array_view->buffer_views[1].data.as_uint8, offset + i)
+                 ? Py_True
+                 : Py_False;
+      Py_INCREF(item);
+    } else if constexpr (std::is_same_v<T, Int64Array>) {
+      item = PyLong_FromLongLong(
+          array_view->buffer_views[1].data.as_int64[offset + i]);
+      if (item == nullptr) {
+        throw nb::python_error();
+      }
+    } else if constexpr (std::is_same_v<T, StringArray>) {
+      const int64_t *offsets = array_view->buffer_views[1].data.as_int64;
+      const int64_t value_start = offsets[offset + i];
+      item = cache.Get(std::string_view(
+          array_view->buffer_views[2].data.as_char + value_start,
+          static_cast<size_t>(offsets[offset + i + 1] - value_start)));
+    } else if constexpr (std::is_same_v<T, StringViewArray>) {
+      item = cache.Get(self.Value(i));
+    } else {
+      // see https://stackoverflow.com/a/64354296/621736
+      static_assert(!sizeof(T), "to_pylist not implemented for type");
+    }
+    PyList_SET_ITEM(list, start + i, item);
+  }
+}
+
+// Builds the list in place, without converting through a std::vector first
+template <typename T> nb::list ToPyList(const T &self) {
+  PyObject *list = PyList_New(self.array_view_->length);
+  if (list == nullptr) {
+    throw nb::python_error();
+  }
+  auto result = nb::steal<nb::list>(list);
+
+  PyStrCache cache;
+  FillPyList(self, list, 0, cache);
+
+  return result;
+}
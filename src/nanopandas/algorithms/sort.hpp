@@ -0,0 +1,414 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../array_types.hpp"
+#include "../dictionary_array.hpp"
+#include "../string_view_array.hpp"
+#include "bitmap.hpp"
+#include "dictionary.hpp"
+#include "generic.hpp"
+#include "parallel.hpp"
+
+// Sorting kernels. Every sort is stable, including descending ones, where
+// equal values also keep their original order. Null rows are split off up
+// front through the validity bitmap and placed before or after the others
+// in their original order, so the sorts themselves only see valid rows
+
+// Below this many rows a comparison sort beats the setup cost of a radix
+// sort
+constexpr int64_t kMinRadixSortSize = 64;
+
+// LSD radix sort of the positions by their int64 values, one byte per
+// pass. The byte histograms for all passes are built in a single sweep over
+// the keys and passes in which every key has the same byte are skipped, so
+// e.g. small non-negative values only take one or two passes. Flipping the
+// sign bit makes the keys sort as unsigned integers; descending order
+// inverts them instead of reversing the result, which keeps ties stable
+inline void RadixSortInt64(const int64_t *values,
+                           std::vector<int64_t> &positions, bool ascending) {
+  const auto n = static_cast<int64_t>(positions.size());
+  if (n < kMinRadixSortSize) {
+    std::stable_sort(positions.begin(), positions.end(),
+                     [values, ascending](int64_t left, int64_t right) {
+                       return ascending ? values[left] < values[right]
+                                        : values[left] > values[right];
+                     });
+    return;
+  }
+
+  constexpr int kPasses = sizeof(uint64_t);
+  std::vector<uint64_t> keys(n);
+  std::vector<std::array<int64_t, 256>> counts(kPasses);
+  for (auto &count : counts) {
+    count.fill(0);
+  }
+  const uint64_t flip = ascending ? uint64_t{1} << 63 : ~(uint64_t{1} << 63);
+  for (int64_t i = 0; i < n; i++) {
+    const uint64_t key = static_cast<uint64_t>(values[positions[i]]) ^ flip;
+    keys[i] = key;
+    for (int pass = 0; pass < kPasses; pass++) {
+      counts[pass][(key >> (8 * pass)) & 0xff]++;
+    }
+  }
+
+  std::vector<uint64_t> keys_out(n);
+  std::vector<int64_t> positions_out(n);
+  for (int pass = 0; pass < kPasses; pass++) {
+    auto &count = counts[pass];
+    const int shift = 8 * pass;
+    if (count[(keys[0] >> shift) & 0xff] == n) {
+      continue;
+    }
+
+    int64_t start = 0;
+    for (auto &bucket : count) {
+      const int64_t size = bucket;
+      bucket = start;
+      start += size;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      const int64_t dest = count[(keys[i] >> shift) & 0xff]++;
+      keys_out[dest] = keys[i];
+      positions_out[dest] = positions[i];
+    }
+    keys.swap(keys_out);
+    positions.swap(positions_out);
+  }
+}
+
+// Counting sort of the positions by their bit: one pass counts the false
+// values, a second writes each position straight to its place
+inline void CountingSortBool(const uint8_t *values, int64_t offset,
+                             std::vector<int64_t> &positions, bool ascending) {
+  int64_t num_false = 0;
+  for (const auto pos : positions) {
+    num_false += !ArrowBitGet(values, offset + pos);
+  }
+
+  std::vector<int64_t> out(positions.size());
+  int64_t false_next = ascending ? 0 : positions.size() - num_false;
+  int64_t true_next = ascending ? num_false : 0;
+  for (const auto pos : positions) {
+    if (ArrowBitGet(values, offset + pos)) {
+      out[true_next++] = pos;
+    } else {
+      out[false_next++] = pos;
+    }
+  }
+  positions.swap(out);
+}
+
+// MSD radix sort of the positions by the bytes of value(position). Each
+// range of positions sharing their first depth bytes is distributed into
+// one bucket per next byte, with strings that have ended in a bucket that
+// comes first (or last when descending) and needs no further sorting.
+// Ranges are kept on an explicit stack, as long shared prefixes would
+// otherwise recurse once per byte, and a range that does not split is only
+// advanced to the next byte. Small ranges fall back to a comparison sort
+template <typename ValueFunc>
+void MsdRadixSortStrings(std::vector<int64_t> &positions, bool ascending,
+                         ValueFunc &&value) {
+  struct Range {
+    int64_t begin;
+    int64_t size;
+    size_t depth;
+  };
+
+  std::vector<int64_t> scratch(positions.size());
+  std::vector<Range> stack{{0, static_cast<int64_t>(positions.size()), 0}};
+  while (!stack.empty()) {
+    auto [begin, size, depth] = stack.back();
+    stack.pop_back();
+    int64_t *range = positions.data() + begin;
+
+    if (size < kMinRadixSortSize) {
+      std::stable_sort(range, range + size, [&](int64_t left, int64_t right) {
+        const auto lhs = value(left).substr(depth);
+        const auto rhs = value(right).substr(depth);
+        return ascending ? lhs < rhs : rhs < lhs;
+      });
+      continue;
+    }
+
+    const auto bucket_of = [&](int64_t pos) -> int {
+      const std::string_view str = value(pos);
+      const int bucket =
+          str.size() <= depth ? 0 : static_cast<uint8_t>(str[depth]) + 1;
+      return ascending ? bucket : 256 - bucket;
+    };
+
+    std::array<int64_t, 258> starts{};
+    for (int64_t i = 0; i < size; i++) {
+      starts[bucket_of(range[i]) + 1]++;
+    }
+
+    const int end_bucket = ascending ? 0 : 256;
+    const int first = static_cast<int>(bucket_of(range[0]));
+    if ((starts[first + 1] == size) && (first != end_bucket)) {
+      stack.push_back({begin, size, depth + 1});
+      continue;
+    }
+
+    for (size_t bucket = 1; bucket < starts.size(); bucket++) {
+      starts[bucket] += starts[bucket - 1];
+    }
+    auto next = starts;
+    for (int64_t i = 0; i < size; i++) {
+      scratch[next[bucket_of(range[i])]++] = range[i];
+    }
+    std::copy(scratch.begin(), scratch.begin() + size, range);
+
+    for (int bucket = 0; bucket < 257; bucket++) {
+      const int64_t bucket_size = starts[bucket + 1] - starts[bucket];
+      if ((bucket != end_bucket) && (bucket_size > 1)) {
+        stack.push_back({begin + starts[bucket], bucket_size, depth + 1});
+      }
+    }
+  }
+}
+
+// Sorts the positions of the valid rows of self by value
+template <typename T>
+void SortValidPositions(const T &self, std::vector<int64_t> &positions,
+                        bool ascending) {
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const int64_t offset = array_view->offset;
+  if constexpr (std::is_same_v<T, BoolArray>) {
+    CountingSortBool(array_view->buffer_views[1].data.as_uint8, offset,
+                     positions, ascending);
+  } else if constexpr (std::is_same_v<T, Int64Array>) {
+    RadixSortInt64(array_view->buffer_views[1].data.as_int64 + offset,
+                   positions, ascending);
+  } else if constexpr (std::is_same_v<T, StringArray>) {
+    const int64_t *offsets = array_view->buffer_views[1].data.as_int64 + offset;
+    const char *data = array_view->buffer_views[2].data.as_char;
+    MsdRadixSortStrings(positions, ascending, [=](int64_t i) {
+      return std::string_view(data + offsets[i],
+                              static_cast<size_t>(offsets[i + 1] - offsets[i]));
+    });
+  } else if constexpr (std::is_same_v<T, StringViewArray>) {
+    MsdRadixSortStrings(positions, ascending,
+                        [&self](int64_t i) { return self.Value(i); });
+  } else if constexpr (std::is_same_v<T, DictionaryStringArray>) {
+    // the dictionary is sorted instead of the rows, after which the rows
+    // only need a counting sort by the rank of their code. Equal entries
+    // share a rank, so rows holding them keep their original order
+    const StringArray &dictionary = self.dictionary();
+    const int64_t dictionary_length = dictionary.array_view_->length;
+    std::vector<int64_t> order(dictionary_length);
+    for (int64_t i = 0; i < dictionary_length; i++) {
+      order[i] = i;
+    }
+    SortValidPositions(dictionary, order, ascending);
+
+    const struct ArrowArrayView *values = dictionary.array_view_.get();
+    const auto value = [values](int64_t i) {
+      const auto sv = ArrowArrayViewGetStringUnsafe(values, i);
+      return std::string_view(sv.data, static_cast<size_t>(sv.size_bytes));
+    };
+    std::vector<int64_t> ranks(dictionary_length);
+    std::vector<int64_t> starts(dictionary_length + 1, 0);
+    for (int64_t k = 0; k < dictionary_length; k++) {
+      const bool same = (k > 0) && (value(order[k]) == value(order[k - 1]));
+      ranks[order[k]] = same ? ranks[order[k - 1]] : k;
+    }
+
+    const int32_t *codes = self.codes();
+    for (const auto pos : positions) {
+      starts[ranks[codes[pos]] + 1]++;
+    }
+    for (int64_t k = 0; k < dictionary_length; k++) {
+      starts[k + 1] += starts[k];
+    }
+    std::vector<int64_t> out(positions.size());
+    for (const auto pos : positions) {
+      out[starts[ranks[codes[pos]]]++] = pos;
+    }
+    positions.swap(out);
+  } else {
+    // see https://stackoverflow.com/a/64354296/621736
+    static_assert(!sizeof(T), "sorting not implemented for type");
+  }
+}
+
+// Returns the positions that sort self, like pandas ExtensionArray.argsort
+template <typename T>
+Int64Array ArgSort(const T &self, bool ascending,
+                   const std::string &na_position) {
+  if ((na_position != "first") && (na_position != "last")) {
+    throw std::invalid_argument("na_position must be 'first' or 'last'");
+  }
+
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const int64_t n = array_view->length;
+  const int64_t offset = array_view->offset;
+  std::vector<int64_t> valid;
+  std::vector<int64_t> nulls;
+  if (self.GetNullCount() > 0) {
+    const uint8_t *validity = array_view->buffer_views[0].data.as_uint8;
+    valid = MaskPositions(n, [=](int64_t i, int64_t nbits) {
+      return LoadBitmapWord(validity, offset + i, nbits);
+    });
+    nulls = MaskPositions(n, [=](int64_t i, int64_t nbits) {
+      const uint64_t word = ~LoadBitmapWord(validity, offset + i, nbits);
+      return nbits < 64 ? word & ((uint64_t{1} << nbits) - 1) : word;
+    });
+  } else {
+    valid.resize(n);
+    ParallelFor(n, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        valid[i] = i;
+      }
+    });
+  }
+
+  SortValidPositions(self, valid, ascending);
+
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_INT64)) {
+    throw std::runtime_error("Unable to init int64 array!");
+  }
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferResize(data, n * sizeof(int64_t), false)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+  auto out = reinterpret_cast<int64_t *>(data->data);
+  const bool nulls_first = na_position == "first";
+  std::copy(nulls.begin(), nulls.end(),
+            out + (nulls_first ? 0 : valid.size()));
+  std::copy(valid.begin(), valid.end(), out + (nulls_first ? nulls.size() : 0));
+
+  result->length = n;
+  result->null_count = 0;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return Int64Array(std::move(result));
+}
+
+// Gathers the rows of self in sorted order. Dictionary arrays only gather
+// their codes and keep the dictionary as is
+template <typename T>
+T Sort(const T &self, bool ascending, const std::string &na_position) {
+  const auto indices = ArgSort(self, ascending, na_position);
+  const struct ArrowArrayView *indices_view = indices.array_view_.get();
+  const int64_t *positions = indices_view->buffer_views[1].data.as_int64;
+  if constexpr (std::is_same_v<T, DictionaryStringArray>) {
+    const auto codes = TakeInternal(DictionaryCodes(self), positions,
+                                    indices_view->length, false, std::nullopt);
+    return DictionaryFromFactorized(codes, self.dictionary());
+  } else {
+    return TakeInternal(self, positions, indices_view->length, false,
+                        std::nullopt);
+  }
+}
+
+// Returns the k largest (or smallest) values of self along with their
+// positions, best first, like pandas' nlargest and nsmallest with
+// keep="first": ties go to the earlier row and nulls are skipped. Each
+// morsel keeps a bounded heap of its k best rows, whose top is the worst
+// of them, so a row only costs a comparison unless it beats that. The
+// heaps of all morsels hold at most k rows each and are merged at the end
+template <typename T>
+std::tuple<T, Int64Array> TopK(const T &self, int64_t k, bool largest) {
+  if (k < 0) {
+    throw std::invalid_argument("k must not be negative");
+  }
+
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const int64_t n = array_view->length;
+  const int64_t offset = array_view->offset;
+  const uint8_t *validity = self.GetNullCount() > 0
+                                ? array_view->buffer_views[0].data.as_uint8
+                                : nullptr;
+
+  const auto value = [array_view, offset](int64_t i) {
+    if constexpr (std::is_same_v<T, Int64Array>) {
+      return array_view->buffer_views[1].data.as_int64[offset + i];
+    } else if constexpr (std::is_same_v<T, StringArray>) {
+      const int64_t *offsets =
+          array_view->buffer_views[1].data.as_int64 + offset;
+      return std::string_view(
+          array_view->buffer_views[2].data.as_char + offsets[i],
+          static_cast<size_t>(offsets[i + 1] - offsets[i]));
+    } else {
+      // see https://stackoverflow.com/a/64354296/621736
+      static_assert(!sizeof(T), "topk not implemented for type");
+    }
+  };
+  const auto better = [&value, largest](int64_t left, int64_t right) {
+    const auto lhs = value(left);
+    const auto rhs = value(right);
+    if (lhs == rhs) {
+      return left < right;
+    }
+    return largest ? rhs < lhs : lhs < rhs;
+  };
+
+  std::vector<std::vector<int64_t>> heaps(MorselCount(n));
+  if (k > 0) {
+    ParallelFor(n, [&](int64_t begin, int64_t end) {
+      auto &heap = heaps[begin / kMorselSize];
+      heap.reserve(std::min(k, end - begin));
+      for (int64_t i = begin; i < end; i++) {
+        if ((validity != nullptr) && !ArrowBitGet(validity, offset + i)) {
+          continue;
+        }
+        if (static_cast<int64_t>(heap.size()) < k) {
+          heap.push_back(i);
+          std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(i, heap.front())) {
+          std::pop_heap(heap.begin(), heap.end(), better);
+          heap.back() = i;
+          std::push_heap(heap.begin(), heap.end(), better);
+        }
+      }
+    });
+  }
+
+  std::vector<int64_t> positions;
+  for (const auto &heap : heaps) {
+    positions.insert(positions.end(), heap.begin(), heap.end());
+  }
+  const auto m = std::min(k, static_cast<int64_t>(positions.size()));
+  std::partial_sort(positions.begin(), positions.begin() + m, positions.end(),
+                    better);
+  positions.resize(m);
+
+  nanoarrow::UniqueArray locs;
+  if (ArrowArrayInitFromType(locs.get(), NANOARROW_TYPE_INT64)) {
+    throw std::runtime_error("Unable to init int64 array!");
+  }
+  struct ArrowBuffer *data = ArrowArrayBuffer(locs.get(), 1);
+  if (ArrowBufferAppend(data, positions.data(), m * sizeof(int64_t))) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+
+  locs->length = m;
+  locs->null_count = 0;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(locs.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  auto values = TakeInternal(self, positions.data(), m, false, std::nullopt);
+  return std::make_tuple(std::move(values), Int64Array{std::move(locs)});
+}
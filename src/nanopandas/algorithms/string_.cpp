@@ -1,197 +1,279 @@
 #include "string_.hpp"
 
-#include <array>
+#include <algorithm>
+#include <cstring>
 #include <functional>
-#include <optional>
 #include <string>
 #include <string_view>
-#include <vector>
 
-StringArray Lower(const StringArray &self) {
-  std::vector<std::optional<std::string>> result;
-  const auto n = self.array_view_->length;
-
-  result.reserve(n);
-  for (int64_t i = 0; i < n; i++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), i)) {
-      result.push_back(std::nullopt);
-    } else {
-      const auto sv = ArrowArrayViewGetStringUnsafe(self.array_view_.get(), i);
-      unsigned char *dst;
-
-      constexpr auto lambda = [](utf8proc_int32_t codepoint,
-                                 [[maybe_unused]] void *) -> utf8proc_int32_t {
-        return utf8proc_tolower(codepoint);
-      };
+#include "ascii.hpp"
+#include "bitmap.hpp"
+#include "builders.hpp"
+#include "parallel.hpp"
+
+// Bytes of the data buffer referenced by the rows of self, which is the
+// whole buffer unless self is a slice
+static std::string_view DataRange(const StringArray &self) {
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const int64_t *offsets =
+      array_view->buffer_views[1].data.as_int64 + array_view->offset;
+  const int64_t first = offsets[0];
+  const int64_t last = offsets[array_view->length];
+  return {array_view->buffer_views[2].data.as_char + first,
+          static_cast<size_t>(last - first)};
+}
 
-      const utf8proc_ssize_t nbytes = utf8proc_map_custom(
-          reinterpret_cast<const uint8_t *>(sv.data), sv.size_bytes, &dst,
-          UTF8PROC_STABLE, lambda, NULL);
-      if (nbytes < 0) {
-        throw std::runtime_error("error occurred converting tolower!");
-      }
+// Case maps an array whose data is entirely ASCII. Every output string is
+// the same number of bytes as its input, so the offsets are just rebased and
+// func(src, dst, offsets, begin, end) only has to fill in the data of rows
+// [begin, end), given the start of the source and destination data
+template <typename Func>
+static StringArray AsciiCaseMapArray(const StringArray &self, Func &&func) {
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_LARGE_STRING)) {
+    throw std::runtime_error("Unable to init large string array!");
+  }
 
-      // utf8proc and std::string but malloc on the heap; maybe we could avoid
-      // a second malloc with a StringArray constructor for raw C pointers
-      std::string converted{};
-      converted.resize(nbytes);
-      memcpy(&converted[0], dst, nbytes);
-      free(dst);
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const int64_t n = array_view->length;
+  const int64_t offset = array_view->offset;
+  const int64_t null_count = self.GetNullCount();
 
-      result.push_back(std::move(converted));
+  if (null_count > 0) {
+    struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result.get());
+    if (ArrowBufferAppendFill(&bitmap->buffer, 0, _ArrowBytesForBits(n))) {
+      throw std::runtime_error("Unable to allocate validity bitmap!");
     }
+    CopyBitmap(array_view->buffer_views[0].data.as_uint8, offset,
+               bitmap->buffer.data, 0, n);
+    bitmap->size_bits = n;
   }
 
-  return StringArray{result};
-}
-
-StringArray Upper(const StringArray &self) {
-  nanoarrow::UniqueArray result;
-  if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_LARGE_STRING)) {
-    throw std::runtime_error("Unable to init large string array!");
+  const int64_t *src_offsets =
+      array_view->buffer_views[1].data.as_int64 + offset;
+  struct ArrowBuffer *offsets = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferResize(offsets, (n + 1) * sizeof(int64_t), false)) {
+    throw std::runtime_error("Unable to allocate offsets buffer!");
   }
-  const auto n = self.array_view_->length;
+  auto out_offsets = reinterpret_cast<int64_t *>(offsets->data);
+  out_offsets[0] = 0;
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      out_offsets[i + 1] = src_offsets[i + 1] - src_offsets[0];
+    }
+  });
 
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
+  const auto src = DataRange(self);
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 2);
+  if (ArrowBufferResize(data, static_cast<int64_t>(src.size()), false)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
   }
+  const auto dst = reinterpret_cast<char *>(data->data);
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    func(src.data(), dst, out_offsets, begin, end);
+  });
+
+  result->length = n;
+  result->null_count = null_count;
 
-  if (ArrowArrayReserve(result.get(), n)) {
-    throw std::runtime_error("Unable to reserve array!");
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
   }
 
-  for (int64_t i = 0; i < n; i++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), i)) {
-      if (ArrowArrayAppendNull(result.get(), 1)) {
-        throw std::runtime_error("failed to append null!");
-      }
-    } else {
-      const auto sv = ArrowArrayViewGetStringUnsafe(self.array_view_.get(), i);
-      unsigned char *dst;
+  return StringArray{std::move(result)};
+}
 
-      constexpr auto lambda = [](utf8proc_int32_t codepoint,
-                                 [[maybe_unused]] void *) -> utf8proc_int32_t {
-        return utf8proc_toupper(codepoint);
-      };
+// Case maps every string of self. ASCII rows are handed to
+// ascii_func(src, dst, nbytes), which must write exactly nbytes; all other
+// rows are decoded and each codepoint is replaced by
+// codepoint_func(codepoint, position_in_row)
+template <typename AsciiFunc, typename CodepointFunc>
+static StringArray MapCodepoints(const StringArray &self,
+                                 AsciiFunc &&ascii_func,
+                                 CodepointFunc &&codepoint_func) {
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const bool has_nulls = self.GetNullCount() > 0;
+
+  StringTransformBuilder builder{self};
+  return builder.Build([&](StringTransformBuilder::RowWriter &writer,
+                           int64_t i) {
+    if (has_nulls && ArrowArrayViewIsNull(array_view, i)) {
+      return;
+    }
 
-      const utf8proc_ssize_t nbytes = utf8proc_map_custom(
-          reinterpret_cast<const uint8_t *>(sv.data), sv.size_bytes, &dst,
-          UTF8PROC_STABLE, lambda, NULL);
-      if (nbytes < 0) {
-        throw std::runtime_error("error occurred converting toupper!");
+    const auto sv = ArrowArrayViewGetStringUnsafe(array_view, i);
+    if (IsAscii(sv.data, sv.size_bytes)) {
+      if (char *out = writer.Extend(sv.size_bytes)) {
+        ascii_func(sv.data, out, sv.size_bytes);
       }
+      return;
+    }
 
-      struct ArrowStringView dest_sv = {reinterpret_cast<const char *>(dst),
-                                        nbytes};
-
-      if (ArrowArrayAppendString(result.get(), dest_sv)) {
-        throw std::runtime_error("failed to append string");
+    int64_t position = 0;
+    int64_t bytes_read = 0;
+    while (bytes_read < sv.size_bytes) {
+      utf8proc_int32_t codepoint;
+      const utf8proc_ssize_t codepoint_bytes = utf8proc_iterate(
+          reinterpret_cast<const utf8proc_uint8_t *>(sv.data + bytes_read),
+          sv.size_bytes - bytes_read, &codepoint);
+      if (codepoint_bytes < 0) {
+        throw std::runtime_error("Invalid UTF-8 data at position " +
+                                 std::to_string(i));
       }
-      free(dst);
+
+      writer.AppendCodepoint(codepoint_func(codepoint, position++));
+      bytes_read += codepoint_bytes;
     }
+  });
+}
+
+StringArray Lower(const StringArray &self) {
+  const auto range = DataRange(self);
+  if (IsAscii(range.data(), static_cast<int64_t>(range.size()))) {
+    return AsciiCaseMapArray(self, [](const char *src, char *dst,
+                                      const int64_t *offsets, int64_t begin,
+                                      int64_t end) {
+      AsciiCaseMap<false>(src + offsets[begin], dst + offsets[begin],
+                       offsets[end] - offsets[begin]);
+    });
   }
 
-  struct ArrowError error;
-  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
-    throw std::runtime_error("Failed to finish building: " +
-                             std::string(error.message));
+  return MapCodepoints(
+      self, AsciiCaseMap<false>,
+      [](utf8proc_int32_t codepoint, int64_t) {
+        return utf8proc_tolower(codepoint);
+      });
+}
+
+StringArray Upper(const StringArray &self) {
+  const auto range = DataRange(self);
+  if (IsAscii(range.data(), static_cast<int64_t>(range.size()))) {
+    return AsciiCaseMapArray(self, [](const char *src, char *dst,
+                                      const int64_t *offsets, int64_t begin,
+                                      int64_t end) {
+      AsciiCaseMap<true>(src + offsets[begin], dst + offsets[begin],
+                       offsets[end] - offsets[begin]);
+    });
   }
 
-  return StringArray{std::move(result)};
+  return MapCodepoints(
+      self, AsciiCaseMap<true>,
+      [](utf8proc_int32_t codepoint, int64_t) {
+        return utf8proc_toupper(codepoint);
+      });
 }
 
 StringArray Capitalize(const StringArray &self) {
-  std::vector<std::optional<std::string>> result;
-  const auto n = self.array_view_->length;
-
-  result.reserve(n);
-  for (int64_t i = 0; i < n; i++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), i)) {
-      result.push_back(std::nullopt);
-    } else {
-      const auto sv = ArrowArrayViewGetStringUnsafe(self.array_view_.get(), i);
-      std::vector<utf8proc_uint8_t> dst;
-      dst.reserve(static_cast<size_t>(sv.size_bytes));
-
-      size_t bytes_read = 0;
-      size_t bytes_rem;
-      while ((bytes_rem = static_cast<size_t>(sv.size_bytes) - bytes_read) >
-             0) {
-        utf8proc_int32_t codepoint;
-        size_t codepoint_bytes = utf8proc_iterate(
-            reinterpret_cast<const utf8proc_uint8_t *>(sv.data + bytes_read),
-            bytes_rem, &codepoint);
-
-        if (bytes_read ==
-            0) { // maybe not the best impl, but easier to template with upper
-          codepoint = utf8proc_toupper(codepoint);
+  const auto range = DataRange(self);
+  if (IsAscii(range.data(), static_cast<int64_t>(range.size()))) {
+    return AsciiCaseMapArray(self, [](const char *src, char *dst,
+                                      const int64_t *offsets, int64_t begin,
+                                      int64_t end) {
+      std::memcpy(dst + offsets[begin], src + offsets[begin],
+                  static_cast<size_t>(offsets[end] - offsets[begin]));
+      for (int64_t i = begin; i < end; i++) {
+        if (offsets[i + 1] > offsets[i]) {
+          dst[offsets[i]] = AsciiToUpper(dst[offsets[i]]);
         }
-        bytes_read += codepoint_bytes;
-
-        std::array<utf8proc_uint8_t, 4> encoded;
-        utf8proc_encode_char(codepoint, encoded.data());
-        dst.insert(dst.end(), encoded.begin(),
-                   encoded.begin() + codepoint_bytes);
       }
-      result.push_back(std::string{dst.begin(), dst.end()});
-    }
+    });
   }
 
-  return StringArray{std::move(result)};
+  return MapCodepoints(
+      self,
+      [](const char *src, char *dst, int64_t nbytes) {
+        std::memcpy(dst, src, static_cast<size_t>(nbytes));
+        if (nbytes > 0) {
+          dst[0] = AsciiToUpper(dst[0]);
+        }
+      },
+      [](utf8proc_int32_t codepoint, int64_t position) {
+        return position == 0 ? utf8proc_toupper(codepoint) : codepoint;
+      });
 }
 
 /*
  * utf8proc applications
  */
+// Strings made up of ASCII are answered from ascii_classes without any
+// decoding; only the remaining strings have func applied to each codepoint
 static BoolArray
-ApplyUtf8ProcFunction(const struct ArrowArrayView *array_view,
+ApplyUtf8ProcFunction(const StringArray &self, uint8_t ascii_classes,
                       const std::function<bool(utf8proc_int32_t)> &func) {
   nanoarrow::UniqueArray result;
   if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_BOOL)) {
     throw std::runtime_error("Unable to init bool array!");
   }
-  const auto n = array_view->length;
 
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const int64_t n = array_view->length;
+  const int64_t offset = array_view->offset;
+  const int64_t null_count = self.GetNullCount();
+
+  if (null_count > 0) {
+    struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result.get());
+    if (ArrowBufferAppendFill(&bitmap->buffer, 0, _ArrowBytesForBits(n))) {
+      throw std::runtime_error("Unable to allocate validity bitmap!");
+    }
+    CopyBitmap(array_view->buffer_views[0].data.as_uint8, offset,
+               bitmap->buffer.data, 0, n);
+    bitmap->size_bits = n;
   }
 
-  if (ArrowArrayReserve(result.get(), n)) {
-    throw std::runtime_error("Unable to reserve array!");
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferAppendFill(data, 0, _ArrowBytesForBits(n))) {
+    throw std::runtime_error("Unable to allocate data buffer!");
   }
 
-  for (int64_t i = 0; i < n; i++) {
-    if (ArrowArrayViewIsNull(array_view, i)) {
-      if (ArrowArrayAppendNull(result.get(), 1)) {
-        throw std::runtime_error("failed to append null!");
-      }
-    } else {
-      const auto sv = ArrowArrayViewGetStringUnsafe(array_view, i);
-
-      size_t bytes_read = 0;
-      size_t bytes_rem;
-
-      bool is_true = true;
-      while ((bytes_rem = static_cast<size_t>(sv.size_bytes) - bytes_read) >
-             0) {
-        utf8proc_int32_t codepoint;
-        size_t codepoint_bytes = utf8proc_iterate(
-            reinterpret_cast<const utf8proc_uint8_t *>(sv.data + bytes_read),
-            bytes_rem, &codepoint);
-
-        is_true = func(codepoint);
-        if (!is_true) {
-          break;
-        }
+  const auto range = DataRange(self);
+  const bool all_ascii =
+      IsAscii(range.data(), static_cast<int64_t>(range.size()));
+
+  const auto evaluate = [&](int64_t i) {
+    // the value behind a null slot is never looked at, so skip the work
+    if (null_count > 0 && ArrowArrayViewIsNull(array_view, i)) {
+      return false;
+    }
+
+    const auto sv = ArrowArrayViewGetStringUnsafe(array_view, i);
+    if (all_ascii || IsAscii(sv.data, sv.size_bytes)) {
+      return AsciiAllOf(sv.data, sv.size_bytes, ascii_classes);
+    }
 
-        bytes_read += codepoint_bytes;
+    size_t bytes_read = 0;
+    size_t bytes_rem;
+    while ((bytes_rem = static_cast<size_t>(sv.size_bytes) - bytes_read) > 0) {
+      utf8proc_int32_t codepoint;
+      size_t codepoint_bytes = utf8proc_iterate(
+          reinterpret_cast<const utf8proc_uint8_t *>(sv.data + bytes_read),
+          bytes_rem, &codepoint);
+
+      if (!func(codepoint)) {
+        return false;
       }
 
-      if (ArrowArrayAppendInt(result.get(), is_true)) {
-        throw std::runtime_error("failed to append bool!");
+      bytes_read += codepoint_bytes;
+    }
+
+    return true;
+  };
+
+  // morsels are aligned to 64 rows, so each one owns whole output words
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i += 64) {
+      const int64_t block = std::min<int64_t>(64, end - i);
+      uint64_t word = 0;
+      for (int64_t j = 0; j < block; j++) {
+        word |= static_cast<uint64_t>(evaluate(i + j)) << j;
       }
+      StoreBitmapWord(data->data, i, word, block);
     }
-  }
+  });
+
+  result->length = n;
+  result->null_count = null_count;
 
   struct ArrowError error;
   if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
@@ -220,7 +302,8 @@ BoolArray IsAlnum(const StringArray &self) {
     }
   };
 
-  return ApplyUtf8ProcFunction(self.array_view_.get(), lambda);
+  return ApplyUtf8ProcFunction(self, kAsciiLower | kAsciiUpper | kAsciiDigit,
+                               lambda);
 }
 
 BoolArray IsAlpha(const StringArray &self) {
@@ -238,7 +321,7 @@ BoolArray IsAlpha(const StringArray &self) {
     }
   };
 
-  return ApplyUtf8ProcFunction(self.array_view_.get(), lambda);
+  return ApplyUtf8ProcFunction(self, kAsciiLower | kAsciiUpper, lambda);
 }
 
 BoolArray IsDigit(const StringArray &self) {
@@ -254,7 +337,7 @@ BoolArray IsDigit(const StringArray &self) {
     }
   };
 
-  return ApplyUtf8ProcFunction(self.array_view_.get(), lambda);
+  return ApplyUtf8ProcFunction(self, kAsciiDigit, lambda);
 }
 
 BoolArray IsSpace(const StringArray &self) {
@@ -270,7 +353,7 @@ BoolArray IsSpace(const StringArray &self) {
     }
   };
 
-  return ApplyUtf8ProcFunction(self.array_view_.get(), lambda);
+  return ApplyUtf8ProcFunction(self, kAsciiSpace, lambda);
 }
 
 BoolArray IsLower(const StringArray &self) {
@@ -278,7 +361,7 @@ BoolArray IsLower(const StringArray &self) {
     return utf8proc_islower(codepoint);
   };
 
-  return ApplyUtf8ProcFunction(self.array_view_.get(), lambda);
+  return ApplyUtf8ProcFunction(self, kAsciiLower, lambda);
 }
 
 BoolArray IsUpper(const StringArray &self) {
@@ -286,5 +369,5 @@ BoolArray IsUpper(const StringArray &self) {
     return utf8proc_isupper(codepoint);
   };
 
-  return ApplyUtf8ProcFunction(self.array_view_.get(), lambda);
+  return ApplyUtf8ProcFunction(self, kAsciiUpper, lambda);
 }
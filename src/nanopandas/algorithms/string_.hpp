@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../array_types.hpp"
+#include "bitmap.hpp"
+#include "parallel.hpp"
 
 #include <utf8proc.h>
 
@@ -23,43 +25,45 @@ template <typename T> Int64Array Len(const T &self) {
   if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_INT64)) {
     throw std::runtime_error("Unable to init int64 array!");
   }
-  const auto n = self.array_view_->length;
 
-  if (ArrowArrayStartAppending(result.get())) {
-    throw std::runtime_error("Could not start appending");
-  }
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const auto n = array_view->length;
+  const auto offset = array_view->offset;
+  const auto null_count = self.GetNullCount();
 
-  if (ArrowArrayReserve(result.get(), n)) {
-    throw std::runtime_error("Unable to reserve array!");
+  if (null_count > 0) {
+    struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result.get());
+    if (ArrowBufferAppendFill(&bitmap->buffer, 0, _ArrowBytesForBits(n))) {
+      throw std::runtime_error("Unable to allocate validity bitmap!");
+    }
+    CopyBitmap(array_view->buffer_views[0].data.as_uint8, offset,
+               bitmap->buffer.data, 0, n);
+    bitmap->size_bits = n;
   }
 
-  for (int64_t i = 0; i < n; i++) {
-    if (ArrowArrayViewIsNull(self.array_view_.get(), i)) {
-      if (ArrowArrayAppendNull(result.get(), 1)) {
-        throw std::runtime_error("failed to append null!");
-      }
-    } else {
-      const auto sv = ArrowArrayViewGetStringUnsafe(self.array_view_.get(), i);
-
-      size_t niter = 0;
-      size_t bytes_read = 0;
-      size_t bytes_rem;
-      while ((bytes_rem = static_cast<size_t>(sv.size_bytes) - bytes_read) >
-             0) {
-        utf8proc_int32_t codepoint;
-        size_t codepoint_bytes = utf8proc_iterate(
-            reinterpret_cast<const utf8proc_uint8_t *>(sv.data + bytes_read),
-            bytes_rem, &codepoint);
-
-        niter++;
-        bytes_read += codepoint_bytes;
-      }
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferResize(data, n * sizeof(int64_t), false)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+  auto out = reinterpret_cast<int64_t *>(data->data);
 
-      if (ArrowArrayAppendInt(result.get(), niter)) {
-        throw std::runtime_error("failed to append int!");
+  // every UTF-8 encoded codepoint has exactly one byte that is not a
+  // continuation byte (0b10xxxxxx), so counting those gives the length
+  // without decoding anything
+  const int64_t *offsets = array_view->buffer_views[1].data.as_int64 + offset;
+  const uint8_t *chars = array_view->buffer_views[2].data.as_uint8;
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      int64_t length = 0;
+      for (int64_t j = offsets[i]; j < offsets[i + 1]; j++) {
+        length += (chars[j] & 0xc0) != 0x80;
       }
+      out[i] = length;
     }
-  }
+  });
+
+  result->length = n;
+  result->null_count = null_count;
 
   struct ArrowError error;
   if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
+
+#include "../string_view_array.hpp"
+#include "bitmap.hpp"
+#include "builders.hpp"
+#include "compare.hpp"
+#include "generic.hpp"
+#include "numpy_.hpp"
+#include "parallel.hpp"
+#include "pyobjects.hpp"
+
+namespace nb = nanobind;
+
+// views address long strings with 31 bit offsets, so the character data of
+// a string array is registered as consecutive buffers of this many bytes,
+// all pointing into the same memory
+constexpr int kStringViewBufferBits = 31;
+
+// Builds views over the characters of self without copying them
+inline StringViewArray ToStringView(const StringArray &self) {
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const auto n = array_view->length;
+  const auto offset = array_view->offset;
+  const auto null_count = self.GetNullCount();
+  const int64_t *offsets = array_view->buffer_views[1].data.as_int64 + offset;
+  const char *chars = array_view->buffer_views[2].data.as_char;
+
+  auto buffers = std::make_shared<StringViewBuffers>();
+  nanoarrow::UniqueArray shared;
+  self.ShareArray(shared.get());
+  buffers->owners.push_back(
+      std::make_shared<const StringArray>(std::move(shared)));
+  const int64_t data_end = n > 0 ? offsets[n] : 0;
+  for (int64_t base = 0; base < data_end;
+       base += int64_t{1} << kStringViewBufferBits) {
+    buffers->data.push_back(chars + base);
+  }
+
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), StringViewArray::ArrowT)) {
+    throw std::runtime_error("Unable to init string view array!");
+  }
+
+  if (null_count > 0) {
+    struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result.get());
+    if (ArrowBufferAppendFill(&bitmap->buffer, 0, _ArrowBytesForBits(n))) {
+      throw std::runtime_error("Unable to allocate validity bitmap!");
+    }
+    CopyBitmap(array_view->buffer_views[0].data.as_uint8, offset,
+               bitmap->buffer.data, 0, n);
+    bitmap->size_bits = n;
+  }
+
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferResize(data, n * sizeof(StringViewEntry), false)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+  auto out = reinterpret_cast<StringViewEntry *>(data->data);
+
+  constexpr int64_t offset_mask = (int64_t{1} << kStringViewBufferBits) - 1;
+  std::vector<uint8_t> too_long(MorselCount(n));
+  ParallelFor(n, [&](int64_t begin, int64_t end) {
+    bool any = false;
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t start = offsets[i];
+      const int64_t size = offsets[i + 1] - start;
+      if (size > std::numeric_limits<int32_t>::max()) {
+        any = true;
+        out[i] = StringViewEntry{};
+        continue;
+      }
+      out[i] = MakeStringView(
+          std::string_view(chars + start, static_cast<size_t>(size)),
+          static_cast<int32_t>(start >> kStringViewBufferBits),
+          static_cast<int32_t>(start & offset_mask));
+    }
+    too_long[begin / kMorselSize] = any;
+  });
+
+  for (const auto flag : too_long) {
+    if (flag) {
+      throw std::overflow_error("strings of 2 GiB or more cannot be viewed");
+    }
+  }
+
+  result->length = n;
+  result->null_count = null_count;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return StringViewArray(std::move(result), std::move(buffers));
+}
+
+inline void InitStringViewArray(StringViewArray *self, nb::handle values) {
+  new (self) StringViewArray(ToStringView(FromPySequence<StringArray>(values)));
+}
+
+inline StringArray StringViewToStringArray(const StringViewArray &self) {
+  const struct ArrowArrayView *array_view = self.array_view_.get();
+  const auto n = array_view->length;
+  const auto null_count = self.GetNullCount();
+
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), StringArray::ArrowT)) {
+    throw std::runtime_error("Unable to init large string array!");
+  }
+
+  const uint8_t *validity = nullptr;
+  if (null_count > 0) {
+    struct ArrowBitmap *bitmap = ArrowArrayValidityBitmap(result.get());
+    if (ArrowBufferAppendFill(&bitmap->buffer, 0, _ArrowBytesForBits(n))) {
+      throw std::runtime_error("Unable to allocate validity bitmap!");
+    }
+    CopyBitmap(array_view->buffer_views[0].data.as_uint8, array_view->offset,
+               bitmap->buffer.data, 0, n);
+    bitmap->size_bits = n;
+    validity = bitmap->buffer.data;
+  }
+
+  BuildStringBuffers(result.get(), n, [&](int64_t i) -> std::string_view {
+    if ((validity != nullptr) && !ArrowBitGet(validity, i)) {
+      return {};
+    }
+    return self.Value(i);
+  });
+
+  result->length = n;
+  result->null_count = null_count;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return StringArray(std::move(result));
+}
+
+// Same as CompareInternal, with a scalar used when right_array is nullptr.
+// Equality checks are mostly settled by the first 8 bytes of each view and
+// ordering by the prefixes, so characters are only read for the rest
+template <typename Op>
+BoolArray StringViewCompareInternal(const StringViewArray &self,
+                                    const StringViewArray *right_array,
+                                    std::string_view right_scalar) {
+  nanoarrow::UniqueArray result;
+  if (ArrowArrayInitFromType(result.get(), NANOARROW_TYPE_BOOL)) {
+    throw std::runtime_error("Unable to init bool array!");
+  }
+
+  const struct ArrowArrayView *left = self.array_view_.get();
+  const auto n = left->length;
+  if ((right_array != nullptr) && (n != right_array->array_view_->length)) {
+    throw std::range_error("Arrays are not of equal size");
+  }
+
+  const bool right_has_nulls =
+      (right_array != nullptr) && (right_array->GetNullCount() > 0);
+  const auto null_count = AndValidity(
+      result.get(), self.GetNullCount() > 0 ? left : nullptr,
+      right_has_nulls ? right_array->array_view_.get() : nullptr, n);
+
+  struct ArrowBuffer *data = ArrowArrayBuffer(result.get(), 1);
+  if (ArrowBufferResize(data, _ArrowBytesForBits(n), false)) {
+    throw std::runtime_error("Unable to allocate data buffer!");
+  }
+
+  // a scalar gets a view of its own for the inline checks, while its
+  // characters are read from the scalar itself
+  const StringViewEntry scalar_view = MakeStringView(right_scalar, 0, 0);
+  const StringViewEntry *left_views = self.views();
+  const StringViewEntry *right_views =
+      right_array != nullptr ? right_array->views() : nullptr;
+
+  FillBitmapWords(data->data, n, [&](int64_t i, int64_t nbits) {
+    return PackWord(i, nbits, [&](int64_t j) {
+      const StringViewEntry &lhs = left_views[j];
+      const StringViewEntry &rhs =
+          right_views != nullptr ? right_views[j] : scalar_view;
+      const auto left_value = [&] { return self.Value(lhs); };
+      const auto right_value = [&] {
+        return right_views != nullptr ? right_array->Value(rhs) : right_scalar;
+      };
+      if constexpr (std::is_same_v<Op, CompareEq>) {
+        return StringViewsEqual(lhs, rhs, left_value, right_value);
+      } else if constexpr (std::is_same_v<Op, CompareNe>) {
+        return !StringViewsEqual(lhs, rhs, left_value, right_value);
+      } else {
+        return Op::Apply(StringViewsCompare(lhs, rhs, left_value, right_value),
+                         0);
+      }
+    });
+  });
+
+  result->length = n;
+  result->null_count = null_count;
+
+  struct ArrowError error;
+  if (ArrowArrayFinishBuildingDefault(result.get(), &error)) {
+    throw std::runtime_error("Failed to finish building: " +
+                             std::string(error.message));
+  }
+
+  return BoolArray(std::move(result));
+}
+
+template <typename Op>
+BoolArray StringViewCompare(const StringViewArray &self,
+                            const StringViewArray &other) {
+  return StringViewCompareInternal<Op>(self, &other, {});
+}
+
+template <typename Op>
+BoolArray StringViewCompareScalar(const StringViewArray &self,
+                                  std::string_view other) {
+  return StringViewCompareInternal<Op>(self, nullptr, other);
+}
+
+inline nb::object StringViewGetItemDunder(const StringViewArray &self,
+                                          nb::object indexer) {
+  const int64_t n = self.array_view_->length;
+
+  int64_t i;
+  if (nb::try_cast(indexer, i, false)) {
+    if ((i >= n) || (i < -n)) {
+      throw std::out_of_range("index out of bounds");
+    }
+    const int64_t idx = i >= 0 ? i : i + n;
+    if (ArrowArrayViewIsNull(self.array_view_.get(), idx)) {
+      return nb::none();
+    }
+    return nb::steal<nb::str>(NewPyStr(self.Value(idx)));
+  }
+
+  // checked before lists of ints as a BoolArray would otherwise be converted
+  // to one
+  if (nb::isinstance<BoolArray>(indexer)) {
+    const auto &mask = nb::cast<const BoolArray &>(indexer);
+    StringViewArray *out = [&] {
+      nb::gil_scoped_release release;
+      return new StringViewArray(FilterByMask(self, mask));
+    }();
+
+    nb::handle py_type = nb::type<StringViewArray>();
+    return nb::inst_take_ownership(py_type, out);
+  }
+
+  // a None in the list gives a missing row, so negative positions are
+  // resolved here and -1 is left to mark the rows take fills
+  std::vector<std::optional<int64_t>> values;
+  if (nb::try_cast(indexer, values, false)) {
+    std::vector<int64_t> positions(values.size());
+    for (size_t k = 0; k < values.size(); k++) {
+      if (!values[k]) {
+        positions[k] = -1;
+        continue;
+      }
+      const int64_t idx = *values[k];
+      if ((idx >= n) || (idx < -n)) {
+        throw std::out_of_range("index out of bounds");
+      }
+      positions[k] = idx >= 0 ? idx : idx + n;
+    }
+
+    nb::gil_scoped_release release;
+    return nb::cast(TakeInternal(self, positions.data(),
+                                 static_cast<int64_t>(positions.size()), true,
+                                 std::nullopt));
+  }
+
+  nb::ndarray<const bool, nb::ndim<1>> array;
+  if (nb::try_cast(indexer, array, false)) {
+    if (static_cast<int64_t>(array.shape(0)) != n) {
+      throw std::out_of_range("boolean index has wrong length");
+    }
+
+    const auto v = array.view();
+    StringViewArray *out = [&] {
+      nb::gil_scoped_release release;
+      return new StringViewArray(Filter(self, [&v](int64_t i, int64_t nbits) {
+        return PackWord(i, nbits, [&v](int64_t j) { return v(j); });
+      }));
+    }();
+
+    nb::handle py_type = nb::type<StringViewArray>();
+    return nb::inst_take_ownership(py_type, out);
+  }
+
+  nb::slice sliceobj;
+  if (nb::try_cast(indexer, sliceobj, false)) {
+    const auto [start, _, step, slice_length] = sliceobj.compute(n);
+    if (step == 1) {
+      return nb::cast(self.Share(static_cast<int64_t>(start),
+                                 static_cast<int64_t>(slice_length)));
+    }
+
+    // strided slices gather their views, which is as cheap as it gets
+    std::vector<int64_t> positions(slice_length);
+    for (size_t k = 0; k < slice_length; k++) {
+      positions[k] = static_cast<int64_t>(start) +
+                     static_cast<int64_t>(k) * static_cast<int64_t>(step);
+    }
+    return nb::cast(TakeInternal(self, positions.data(),
+                                 static_cast<int64_t>(slice_length), false,
+                                 std::nullopt));
+  }
+
+  throw std::out_of_range(
+      "only integers, slices (`:`), lists of integers and boolean arrays are "
+      "valid indices");
+}
+
+// Views hold the same values as a string array, so they share its dtype
+inline ExtensionDtype<StringArray>
+StringViewDtype([[maybe_unused]] const StringViewArray &self) {
+  return ExtensionDtype<StringArray>();
+}
+
+// Strings have no native numpy type, so they become an object array of str,
+// with missing rows set to na_value. copy is accepted for pandas'
+// signature; a new array is always built
+inline nb::object StringViewToNumpy(const StringViewArray &self,
+                                    nb::handle dtype,
+                                    [[maybe_unused]] bool copy,
+                                    nb::handle na_value) {
+  nb::list values = ToPyList(self);
+  if (self.GetNullCount() > 0 && !IsNoValue(na_value)) {
+    for (size_t k = 0; k < values.size(); k++) {
+      if (values[k].is_none()) {
+        values[k] = na_value;
+      }
+    }
+  }
+
+  const nb::object target =
+      dtype.is_none() ? nb::str("O") : nb::borrow<nb::object>(dtype);
+  using namespace nb::literals;
+  const nb::object numpy_array = nb::module_::import_("numpy").attr("array");
+  return numpy_array(values, "dtype"_a = target);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <nanoarrow/nanoarrow.hpp>
 #include <nanobind/nanobind.h>
 #include <optional>
@@ -10,10 +12,112 @@ namespace nb = nanobind;
 
 class ExtensionArray {
 public: // TODO: can we make these private / protected?
-  nanoarrow::UniqueArrayView array_view_;
+  // mutable so that const kernels can hand the view to nanoarrow functions
+  // taking a non-const pointer. Nothing may write through it after SetArray,
+  // as kernels release the GIL and may run on the same array concurrently
+  mutable nanoarrow::UniqueArrayView array_view_;
+
+  ExtensionArray() = default;
+  ExtensionArray(ExtensionArray &&other) noexcept
+      : array_view_(std::move(other.array_view_)),
+        array_(std::move(other.array_)),
+        null_count_(other.null_count_.load(std::memory_order_relaxed)) {}
+  ExtensionArray &operator=(ExtensionArray &&other) noexcept {
+    array_view_ = std::move(other.array_view_);
+    array_ = std::move(other.array_);
+    null_count_.store(other.null_count_.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    return *this;
+  }
+
+  // Sliced and imported arrays may not know their null count, so it is only
+  // counted the first time it is asked for. Kernels run without the GIL, so
+  // the count is cached in an atomic; threads racing to fill it in compute
+  // the same value and only the first one is stored
+  int64_t GetNullCount() const {
+    int64_t null_count = null_count_.load(std::memory_order_relaxed);
+    if (null_count >= 0) {
+      return null_count;
+    }
+
+    const uint8_t *validity = array_view_->buffer_views[0].data.as_uint8;
+    const int64_t n = array_view_->length;
+    null_count = validity == nullptr
+                     ? 0
+                     : n - ArrowBitCountSet(validity, array_view_->offset, n);
+    int64_t unknown = -1;
+    null_count_.compare_exchange_strong(unknown, null_count,
+                                        std::memory_order_relaxed);
+    return null_count;
+  }
+
+  // Populates out with an ArrowArray that references the buffers of this
+  // array instead of copying them. The buffers stay alive until both this
+  // object and every shared array have been released
+  void ShareArray(struct ArrowArray *out) const {
+    ShareArray(out, 0, array_view_->length);
+  }
+
+  // Same as above but only exposes length elements starting at offset
+  void ShareArray(struct ArrowArray *out, int64_t offset,
+                  int64_t length) const {
+    const struct ArrowArray *parent = array_->get();
+    if (parent->n_children != 0) {
+      throw std::runtime_error("Sharing nested arrays is not implemented!");
+    }
+
+    auto private_data = new SharedArrayPrivate{array_, {}};
+    for (int64_t i = 0; i < parent->n_buffers; i++) {
+      private_data->buffers[i] = parent->buffers[i];
+    }
+
+    const int64_t null_count = null_count_.load(std::memory_order_relaxed);
+    out->length = length;
+    if ((offset == 0) && (length == array_view_->length)) {
+      out->null_count = null_count;
+    } else {
+      // left for the receiving array or Arrow consumer to count lazily
+      out->null_count = null_count == 0 ? 0 : -1;
+    }
+    out->offset = parent->offset + offset;
+    out->n_buffers = parent->n_buffers;
+    out->n_children = 0;
+    out->buffers = private_data->buffers;
+    out->children = nullptr;
+    out->dictionary = nullptr;
+    out->release = &ReleaseSharedArray;
+    out->private_data = private_data;
+  }
 
 protected:
-  nanoarrow::UniqueArray array_;
+  void SetArray(nanoarrow::UniqueArray &&array, enum ArrowType type) {
+    array_ = std::make_shared<nanoarrow::UniqueArray>(std::move(array));
+    ArrowArrayViewInitFromType(array_view_.get(), type);
+    struct ArrowError error;
+    if (ArrowArrayViewSetArray(array_view_.get(), array_->get(), &error)) {
+      throw std::runtime_error("Failed to set array view:" +
+                               std::string(error.message));
+    }
+
+    null_count_.store(array_view_->null_count, std::memory_order_relaxed);
+  }
+
+  // shared so that arrays exported via ShareArray can outlive this object
+  std::shared_ptr<nanoarrow::UniqueArray> array_;
+
+private:
+  // -1 until counted, see GetNullCount
+  mutable std::atomic<int64_t> null_count_{-1};
+
+  struct SharedArrayPrivate {
+    std::shared_ptr<nanoarrow::UniqueArray> parent;
+    const void *buffers[NANOARROW_MAX_FIXED_BUFFERS];
+  };
+
+  static void ReleaseSharedArray(struct ArrowArray *array) {
+    delete static_cast<SharedArrayPrivate *>(array->private_data);
+    array->release = nullptr;
+  }
 };
 
 class BoolArray : public ExtensionArray {
@@ -36,48 +140,39 @@ public:
     //              std::is_same<typename C::value_type,
     //                           std::optional<bool>>::value);
 
-    if (ArrowArrayInitFromType(array_.get(), NANOARROW_TYPE_BOOL)) {
+    nanoarrow::UniqueArray array;
+    if (ArrowArrayInitFromType(array.get(), NANOARROW_TYPE_BOOL)) {
       throw std::runtime_error("Unable to init BoolArray!");
     }
 
-    if (ArrowArrayStartAppending(array_.get())) {
+    if (ArrowArrayStartAppending(array.get())) {
       throw std::runtime_error("Could not append to BoolArray!");
     }
 
     for (const auto &opt_boolean : booleans) {
       if (const auto &boolean = opt_boolean) {
-        if (ArrowArrayAppendInt(array_.get(), *boolean)) {
+        if (ArrowArrayAppendInt(array.get(), *boolean)) {
           throw std::invalid_argument("Could not append integer: " +
                                       std::to_string(*boolean));
         }
       } else {
-        if (ArrowArrayAppendNull(array_.get(), 1)) {
+        if (ArrowArrayAppendNull(array.get(), 1)) {
           throw std::invalid_argument("Failed to append null!");
         }
       }
     }
 
     struct ArrowError error;
-    if (ArrowArrayFinishBuildingDefault(array_.get(), &error)) {
+    if (ArrowArrayFinishBuildingDefault(array.get(), &error)) {
       throw std::runtime_error("Failed to finish building array!" +
                                std::string(error.message));
     }
 
-    ArrowArrayViewInitFromType(array_view_.get(), NANOARROW_TYPE_INT64);
-    if (ArrowArrayViewSetArray(array_view_.get(), array_.get(), &error)) {
-      throw std::runtime_error("Failed to set array view!" +
-                               std::string(error.message));
-    }
+    SetArray(std::move(array), ArrowT);
   }
 
   BoolArray(nanoarrow::UniqueArray &&array) {
-    array_ = std::move(array);
-    ArrowArrayViewInitFromType(array_view_.get(), NANOARROW_TYPE_BOOL);
-    struct ArrowError error;
-    if (ArrowArrayViewSetArray(array_view_.get(), array_.get(), &error)) {
-      throw std::runtime_error("Failed to set array view:" +
-                               std::string(error.message));
-    }
+    SetArray(std::move(array), ArrowT);
   }
 };
 
@@ -101,45 +196,37 @@ public:
     //              std::is_same<typename C::value_type,
     //                           std::optional<std::string_view>>::value);
 
-    if (ArrowArrayInitFromType(array_.get(), NANOARROW_TYPE_INT64)) {
+    nanoarrow::UniqueArray array;
+    if (ArrowArrayInitFromType(array.get(), NANOARROW_TYPE_INT64)) {
       throw std::runtime_error("Unable to init Int64Array!");
     };
 
-    if (ArrowArrayStartAppending(array_.get())) {
+    if (ArrowArrayStartAppending(array.get())) {
       throw std::runtime_error("Could not append to Int64Array!");
     }
 
     for (const auto &opt_integer : integers) {
       if (const auto &integer = opt_integer) {
-        if (ArrowArrayAppendInt(array_.get(), *integer)) {
+        if (ArrowArrayAppendInt(array.get(), *integer)) {
           throw std::invalid_argument("Could not append integer: " +
                                       std::to_string(*integer));
         }
       } else {
-        if (ArrowArrayAppendNull(array_.get(), 1)) {
+        if (ArrowArrayAppendNull(array.get(), 1)) {
           throw std::invalid_argument("Failed to append null!");
         }
       }
     }
 
-    if (ArrowArrayFinishBuildingDefault(array_.get(), nullptr)) {
+    if (ArrowArrayFinishBuildingDefault(array.get(), nullptr)) {
       throw std::runtime_error("Failed to finish building array!");
     }
 
-    ArrowArrayViewInitFromType(array_view_.get(), NANOARROW_TYPE_INT64);
-    if (ArrowArrayViewSetArray(array_view_.get(), array_.get(), nullptr)) {
-      throw std::runtime_error("Failed to set array view!");
-    }
+    SetArray(std::move(array), ArrowT);
   }
 
   Int64Array(nanoarrow::UniqueArray &&array) {
-    array_ = std::move(array);
-    ArrowArrayViewInitFromType(array_view_.get(), NANOARROW_TYPE_INT64);
-    struct ArrowError error;
-    if (ArrowArrayViewSetArray(array_view_.get(), array_.get(), &error)) {
-      throw std::runtime_error("Failed to set array view:" +
-                               std::string(error.message));
-    }
+    SetArray(std::move(array), ArrowT);
   }
 };
 
@@ -162,15 +249,16 @@ public:
                                std::optional<std::string>>::value ||
                   std::is_same<typename C::value_type,
                                std::optional<std::string_view>>::value);
-    if (ArrowArrayInitFromType(array_.get(), NANOARROW_TYPE_LARGE_STRING)) {
+    nanoarrow::UniqueArray array;
+    if (ArrowArrayInitFromType(array.get(), NANOARROW_TYPE_LARGE_STRING)) {
       throw std::runtime_error("Unable to init StringArray!");
     };
 
-    if (ArrowArrayStartAppending(array_.get())) {
+    if (ArrowArrayStartAppending(array.get())) {
       throw std::runtime_error("Could not append to StringArray!");
     }
 
-    if (ArrowArrayReserve(array_.get(), strings.size())) {
+    if (ArrowArrayReserve(array.get(), strings.size())) {
       throw std::runtime_error("Unable to reserve array!");
     }
 
@@ -178,35 +266,26 @@ public:
       if (const auto &str = opt_str) {
         struct ArrowStringView sv = {str->data(),
                                      static_cast<int64_t>(str->size())};
-        if (ArrowArrayAppendString(array_.get(), sv)) {
+        if (ArrowArrayAppendString(array.get(), sv)) {
           throw std::invalid_argument("Could not append string: " +
                                       std::string(*str));
         }
       } else {
-        if (ArrowArrayAppendNull(array_.get(), 1)) {
+        if (ArrowArrayAppendNull(array.get(), 1)) {
           throw std::invalid_argument("Failed to append null!");
         }
       }
     }
 
-    if (ArrowArrayFinishBuildingDefault(array_.get(), nullptr)) {
+    if (ArrowArrayFinishBuildingDefault(array.get(), nullptr)) {
       throw std::runtime_error("Failed to finish building array!");
     }
 
-    ArrowArrayViewInitFromType(array_view_.get(), NANOARROW_TYPE_LARGE_STRING);
-    if (ArrowArrayViewSetArray(array_view_.get(), array_.get(), nullptr)) {
-      throw std::runtime_error("Failed to set array view!");
-    }
+    SetArray(std::move(array), ArrowT);
   }
 
   StringArray(nanoarrow::UniqueArray &&array) {
-    array_ = std::move(array);
-    ArrowArrayViewInitFromType(array_view_.get(), NANOARROW_TYPE_LARGE_STRING);
-    struct ArrowError error;
-    if (ArrowArrayViewSetArray(array_view_.get(), array_.get(), &error)) {
-      throw std::runtime_error("Failed to set array view:" +
-                               std::string(error.message));
-    }
+    SetArray(std::move(array), ArrowT);
   }
 };
 
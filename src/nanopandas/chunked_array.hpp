@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "array_types.hpp"
+
+// A logical array made up of a sequence of chunks of type T. Chunks share
+// the buffers of the arrays they were created from, so concatenating chunked
+// arrays only copies references and stays linear in the number of chunks no
+// matter how much data they hold. Nothing is made contiguous until
+// combine_chunks is explicitly called
+template <typename T> class ChunkedArray {
+public:
+  using ChunkT = T;
+
+  explicit ChunkedArray(std::vector<T> &&chunks) : chunks_(std::move(chunks)) {
+    chunk_starts_.reserve(chunks_.size() + 1);
+    chunk_starts_.push_back(0);
+    for (const auto &chunk : chunks_) {
+      chunk_starts_.push_back(chunk_starts_.back() + chunk.array_view_->length);
+    }
+  }
+
+  // references the given arrays without copying any of their data
+  explicit ChunkedArray(const std::vector<const T *> &arrays)
+      : ChunkedArray(ShareAll(arrays)) {}
+
+  const std::vector<T> &chunks() const { return chunks_; }
+
+  int64_t length() const { return chunk_starts_.back(); }
+
+  // position of the first element of each chunk, followed by the length
+  const std::vector<int64_t> &chunk_starts() const { return chunk_starts_; }
+
+  // Locates the chunk holding the element at a non-negative index, returning
+  // the chunk number and the index within that chunk
+  std::pair<size_t, int64_t> Locate(int64_t index) const {
+    if ((index < 0) || (index >= length())) {
+      throw std::out_of_range("index out of bounds");
+    }
+
+    const auto it = std::upper_bound(chunk_starts_.begin() + 1,
+                                     chunk_starts_.end(), index);
+    const auto chunk = static_cast<size_t>(it - chunk_starts_.begin() - 1);
+    return {chunk, index - chunk_starts_[chunk]};
+  }
+
+  static T ShareChunk(const T &array) {
+    nanoarrow::UniqueArray shared;
+    array.ShareArray(shared.get());
+    return T(std::move(shared));
+  }
+
+  static T ShareChunk(const T &array, int64_t offset, int64_t length) {
+    nanoarrow::UniqueArray shared;
+    array.ShareArray(shared.get(), offset, length);
+    return T(std::move(shared));
+  }
+
+private:
+  static std::vector<T> ShareAll(const std::vector<const T *> &arrays) {
+    std::vector<T> chunks;
+    chunks.reserve(arrays.size());
+    for (size_t i = 0; i < arrays.size(); i++) {
+      // None converts to a null pointer when binding a list of arrays
+      if (arrays[i] == nullptr) {
+        const auto message = "chunk at position " + std::to_string(i) +
+                             " is None, expected " + T::Name;
+        throw nb::type_error(message.c_str());
+      }
+      chunks.push_back(ShareChunk(*arrays[i]));
+    }
+    return chunks;
+  }
+
+  std::vector<T> chunks_;
+  std::vector<int64_t> chunk_starts_;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "array_types.hpp"
+
+// A string array stored as int32 codes into a dictionary of distinct strings,
+// like Arrow's dictionary encoded arrays and pandas' Categorical. The codes
+// are the array itself as far as ExtensionArray is concerned, so they carry
+// the length, offset and validity. Null rows always hold a code of -1, which
+// lets kernels gather through the codes with take semantics. The dictionary
+// never holds nulls, though it may hold a value more than once, e.g. after
+// lowercasing
+class DictionaryStringArray : public ExtensionArray {
+public:
+  static constexpr enum ArrowType ArrowT = NANOARROW_TYPE_INT32;
+
+  DictionaryStringArray(nanoarrow::UniqueArray &&codes,
+                        StringArray &&dictionary)
+      : dictionary_(std::move(dictionary)) {
+    if (dictionary_.GetNullCount() > 0) {
+      throw std::invalid_argument("dictionary must not contain nulls");
+    }
+    SetArray(std::move(codes), ArrowT);
+  }
+
+  const StringArray &dictionary() const { return dictionary_; }
+
+  const int32_t *codes() const {
+    return array_view_->buffer_views[1].data.as_int32 + array_view_->offset;
+  }
+
+  // Returns a new array over the same dictionary and the codes of rows
+  // [offset, offset + length), without copying either
+  DictionaryStringArray Share(int64_t offset, int64_t length) const {
+    nanoarrow::UniqueArray codes;
+    ShareArray(codes.get(), offset, length);
+    nanoarrow::UniqueArray dictionary;
+    dictionary_.ShareArray(dictionary.get());
+    return DictionaryStringArray(std::move(codes),
+                                 StringArray(std::move(dictionary)));
+  }
+
+private:
+  StringArray dictionary_;
+};
@@ -9,13 +9,21 @@
 
 namespace nb = nanobind;
 
+// for kernels that only touch C++ objects, letting other Python threads run
+// while they work
+static constexpr auto kReleaseGIL = nb::call_guard<nb::gil_scoped_release>();
+
 // try to match all pandas methods
 // https://pandas.pydata.org/pandas-docs/stable/user_guide/text.html#method-summary
 NB_MODULE(nanopandas_ext, m) {
+  m.def("set_num_threads", &SetNumThreads, nb::arg("num_threads"),
+        "Set the number of threads used by kernels; 0 uses all cores");
+  m.def("get_num_threads", &GetNumThreads);
+
   nb::class_<ExtensionArray>(m, "ExtensionArray");
 
   nb::class_<BoolArray, ExtensionArray>(m, "BoolArray")
-      .def(nb::init<std::vector<std::optional<bool>>>())
+      .def("__init__", &InitFromPySequence<BoolArray>, nb::arg("values"))
       .def("__len__", &LenDunder<BoolArray>)
       .def_prop_ro("dtype", &Dtype<BoolArray>)
       .def_prop_ro("nbytes", &Nbytes<BoolArray>)
@@ -26,20 +34,67 @@ NB_MODULE(nanopandas_ext, m) {
       .def("all", &All<BoolArray>)
       .def("__repr__", &ReprDunder<BoolArray>)
       .def("__getitem__", &GetItemDunder<BoolArray>)
-      .def("__eq__", &EqDunder<BoolArray>)
-      .def("isna", &IsNA<BoolArray>)
-      .def("take", &Take<BoolArray>)
-      .def("copy", &Copy<BoolArray>)
-      .def("fillna", &FillNA<BoolArray>)
-      .def("dropna", &DropNA<BoolArray>)
-      .def("interpolate", &Interpolate<BoolArray>)
-      .def("unique", &Unique<BoolArray>)
-      .def("factorize", &Factorize<BoolArray>)
-      .def("_pad_or_backfill", &PadOrBackfill<BoolArray>)
+      .def("__eq__", &Compare<CompareEq, BoolArray>, kReleaseGIL)
+      .def("__eq__", &CompareScalar<CompareEq, BoolArray>, kReleaseGIL)
+      .def("__ne__", &Compare<CompareNe, BoolArray>, kReleaseGIL)
+      .def("__ne__", &CompareScalar<CompareNe, BoolArray>, kReleaseGIL)
+      .def("__lt__", &Compare<CompareLt, BoolArray>, kReleaseGIL)
+      .def("__lt__", &CompareScalar<CompareLt, BoolArray>, kReleaseGIL)
+      .def("__le__", &Compare<CompareLe, BoolArray>, kReleaseGIL)
+      .def("__le__", &CompareScalar<CompareLe, BoolArray>, kReleaseGIL)
+      .def("__gt__", &Compare<CompareGt, BoolArray>, kReleaseGIL)
+      .def("__gt__", &CompareScalar<CompareGt, BoolArray>, kReleaseGIL)
+      .def("__ge__", &Compare<CompareGe, BoolArray>, kReleaseGIL)
+      .def("__ge__", &CompareScalar<CompareGe, BoolArray>, kReleaseGIL)
+      .def("isna", &IsNA<BoolArray>, kReleaseGIL)
+      .def("take", &Take<BoolArray>, nb::arg("indices"),
+           nb::arg("allow_fill") = false, nb::arg("fill_value") = nb::none())
+      .def("copy", &Copy<BoolArray>, nb::arg("deep") = true, kReleaseGIL)
+      .def("fillna", &FillNA<BoolArray>, kReleaseGIL)
+      .def("dropna", &DropNA<BoolArray>, kReleaseGIL)
+      .def("interpolate", &Interpolate<BoolArray>, kReleaseGIL)
+      .def("unique", &Unique<BoolArray>, nb::arg("sort") = false, kReleaseGIL)
+      .def("argsort", &ArgSort<BoolArray>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("sort", &Sort<BoolArray>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("factorize", &Factorize<BoolArray>,
+           nb::arg("size_hint") = nb::none(), kReleaseGIL)
+      .def("_pad_or_backfill", &PadOrBackfill<BoolArray>, kReleaseGIL)
       .def("_from_sequence", &FromSequence<BoolArray>)
-      .def("_from_factorized", &FromFactorized<BoolArray>)
+      .def("_from_factorized", &FromFactorized<BoolArray>, kReleaseGIL)
       .def("to_pylist", &ToPyList<BoolArray>)
-      .def("_concat_same_type", &ConcatSameType<BoolArray>);
+      .def("_concat_same_type", &ConcatSameType<BoolArray>,
+           nb::arg("to_concat") = nb::none())
+      .def("__arrow_c_schema__", &ArrowCSchema<BoolArray>)
+      .def("__arrow_c_array__", &ArrowCArray<BoolArray>,
+           nb::arg("requested_schema") = nb::none())
+      .def_static("from_arrow", &FromArrow<BoolArray>)
+      .def("to_numpy", &ToNumpy<BoolArray>, nb::arg("dtype") = nb::none(),
+           nb::arg("copy") = false, nb::arg("na_value") = nb::none())
+      .def("to_numpy_masked", &ToNumpyMasked<BoolArray>)
+      .def("__array__", &ArrayDunder<BoolArray>, nb::arg("dtype") = nb::none(),
+           nb::arg("copy") = nb::none())
+      .def_static("from_numpy", &FromNumpy<BoolArray>, nb::arg("values"),
+                  nb::arg("mask") = nb::none())
+
+      // Kleene logical operators
+      .def("__and__", &Logical<LogicalAnd, BoolArray>, kReleaseGIL)
+      .def("__and__", &LogicalScalar<LogicalAnd, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__rand__", &LogicalScalar<LogicalAnd, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__or__", &Logical<LogicalOr, BoolArray>, kReleaseGIL)
+      .def("__or__", &LogicalScalar<LogicalOr, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__ror__", &LogicalScalar<LogicalOr, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__xor__", &Logical<LogicalXor, BoolArray>, kReleaseGIL)
+      .def("__xor__", &LogicalScalar<LogicalXor, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__rxor__", &LogicalScalar<LogicalXor, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__invert__", &InvertDunder<BoolArray>, kReleaseGIL);
 
   nb::class_<ExtensionDtype<BoolArray>>(m, "BoolDtype")
       .def("__str__", &ExtensionDtype<BoolArray>::Str)
@@ -52,7 +107,7 @@ NB_MODULE(nanopandas_ext, m) {
       .def_prop_ro("_is_immutable", &ExtensionDtype<BoolArray>::IsImmutable);
 
   nb::class_<Int64Array, ExtensionArray>(m, "Int64Array")
-      .def(nb::init<std::vector<std::optional<int64_t>>>())
+      .def("__init__", &InitFromPySequence<Int64Array>, nb::arg("values"))
       .def("__len__", &LenDunder<Int64Array>)
       .def_prop_ro("dtype", &Dtype<Int64Array>)
       .def_prop_ro("nbytes", &Nbytes<Int64Array>)
@@ -63,25 +118,92 @@ NB_MODULE(nanopandas_ext, m) {
       .def("all", &All<Int64Array>)
       .def("__repr__", &ReprDunder<Int64Array>)
       .def("__getitem__", &GetItemDunder<Int64Array>)
-      .def("__eq__", &EqDunder<Int64Array>)
-      .def("isna", &IsNA<Int64Array>)
-      .def("take", &Take<Int64Array>)
-      .def("copy", &Copy<Int64Array>)
-      .def("fillna", &FillNA<Int64Array>)
-      .def("dropna", &DropNA<Int64Array>)
-      .def("interpolate", &Interpolate<Int64Array>)
-      .def("unique", &Unique<Int64Array>)
-      .def("factorize", &Factorize<Int64Array>)
-      .def("_pad_or_backfill", &PadOrBackfill<Int64Array>)
+      .def("__eq__", &Compare<CompareEq, Int64Array>, kReleaseGIL)
+      .def("__eq__", &CompareScalar<CompareEq, Int64Array>, kReleaseGIL)
+      .def("__ne__", &Compare<CompareNe, Int64Array>, kReleaseGIL)
+      .def("__ne__", &CompareScalar<CompareNe, Int64Array>, kReleaseGIL)
+      .def("__lt__", &Compare<CompareLt, Int64Array>, kReleaseGIL)
+      .def("__lt__", &CompareScalar<CompareLt, Int64Array>, kReleaseGIL)
+      .def("__le__", &Compare<CompareLe, Int64Array>, kReleaseGIL)
+      .def("__le__", &CompareScalar<CompareLe, Int64Array>, kReleaseGIL)
+      .def("__gt__", &Compare<CompareGt, Int64Array>, kReleaseGIL)
+      .def("__gt__", &CompareScalar<CompareGt, Int64Array>, kReleaseGIL)
+      .def("__ge__", &Compare<CompareGe, Int64Array>, kReleaseGIL)
+      .def("__ge__", &CompareScalar<CompareGe, Int64Array>, kReleaseGIL)
+      .def("isna", &IsNA<Int64Array>, kReleaseGIL)
+      .def("take", &Take<Int64Array>, nb::arg("indices"),
+           nb::arg("allow_fill") = false, nb::arg("fill_value") = nb::none())
+      .def("copy", &Copy<Int64Array>, nb::arg("deep") = true, kReleaseGIL)
+      .def("fillna", &FillNA<Int64Array>, kReleaseGIL)
+      .def("dropna", &DropNA<Int64Array>, kReleaseGIL)
+      .def("interpolate", &Interpolate<Int64Array>, kReleaseGIL)
+      .def("unique", &Unique<Int64Array>, nb::arg("sort") = false, kReleaseGIL)
+      .def("argsort", &ArgSort<Int64Array>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("sort", &Sort<Int64Array>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("topk", &TopK<Int64Array>, nb::arg("k"), nb::arg("largest") = true,
+           kReleaseGIL)
+      .def("factorize", &Factorize<Int64Array>,
+           nb::arg("size_hint") = nb::none(), kReleaseGIL)
+      .def("_pad_or_backfill", &PadOrBackfill<Int64Array>, kReleaseGIL)
       .def("_from_sequence", &FromSequence<Int64Array>)
-      .def("_from_factorized", &FromFactorized<Int64Array>)
+      .def("_from_factorized", &FromFactorized<Int64Array>, kReleaseGIL)
       .def("to_pylist", &ToPyList<Int64Array>)
-      .def("_concat_same_type", &ConcatSameType<Int64Array>)
+      .def("_concat_same_type", &ConcatSameType<Int64Array>,
+           nb::arg("to_concat") = nb::none())
+      .def("__arrow_c_schema__", &ArrowCSchema<Int64Array>)
+      .def("__arrow_c_array__", &ArrowCArray<Int64Array>,
+           nb::arg("requested_schema") = nb::none())
+      .def_static("from_arrow", &FromArrow<Int64Array>)
+      .def("to_numpy", &ToNumpy<Int64Array>, nb::arg("dtype") = nb::none(),
+           nb::arg("copy") = false, nb::arg("na_value") = nb::none())
+      .def("to_numpy_masked", &ToNumpyMasked<Int64Array>)
+      .def("__array__", &ArrayDunder<Int64Array>, nb::arg("dtype") = nb::none(),
+           nb::arg("copy") = nb::none())
+      .def_static("from_numpy", &FromNumpy<Int64Array>, nb::arg("values"),
+                  nb::arg("mask") = nb::none())
 
       // integral-specific algorithms
-      .def("sum", &Sum<Int64Array>)
-      .def("min", &Min<Int64Array>)
-      .def("max", &Max<Int64Array>);
+      .def("sum", &Sum<Int64Array>, nb::arg("skipna") = true,
+           nb::arg("min_count") = 0, kReleaseGIL)
+      .def("min", &Min<Int64Array>, nb::arg("skipna") = true, kReleaseGIL)
+      .def("max", &Max<Int64Array>, nb::arg("skipna") = true, kReleaseGIL)
+
+      // arithmetic; overflow raises OverflowError unless check_overflow is
+      // False, in which case results wrap around
+      .def("__add__", &Arithmetic<ArithmeticAdd, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__add__", &ArithmeticScalar<ArithmeticAdd, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__radd__", &ArithmeticScalar<ArithmeticAdd, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__sub__", &Arithmetic<ArithmeticSub, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__sub__", &ArithmeticScalar<ArithmeticSub, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__rsub__", &ReflectedArithmeticScalar<ArithmeticSub, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__mul__", &Arithmetic<ArithmeticMul, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__mul__", &ArithmeticScalar<ArithmeticMul, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__rmul__", &ArithmeticScalar<ArithmeticMul, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__floordiv__", &Arithmetic<ArithmeticFloorDiv, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__floordiv__", &ArithmeticScalar<ArithmeticFloorDiv, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__rfloordiv__",
+           &ReflectedArithmeticScalar<ArithmeticFloorDiv, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__mod__", &Arithmetic<ArithmeticMod, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__mod__", &ArithmeticScalar<ArithmeticMod, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__rmod__", &ReflectedArithmeticScalar<ArithmeticMod, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__neg__", &Negate<Int64Array>, kReleaseGIL);
 
   nb::class_<ExtensionDtype<Int64Array>>(m, "Int64Dtype")
       .def("__str__", &ExtensionDtype<Int64Array>::Str)
@@ -94,7 +216,7 @@ NB_MODULE(nanopandas_ext, m) {
       .def_prop_ro("_is_immutable", &ExtensionDtype<Int64Array>::IsImmutable);
 
   nb::class_<StringArray, ExtensionArray>(m, "StringArray")
-      .def(nb::init<std::vector<std::optional<std::string_view>>>())
+      .def("__init__", &InitFromPySequence<StringArray>, nb::arg("values"))
       .def("__len__", &LenDunder<StringArray>)
       .def_prop_ro("dtype", &Dtype<StringArray>)
       .def_prop_ro("nbytes", &Nbytes<StringArray>)
@@ -105,32 +227,58 @@ NB_MODULE(nanopandas_ext, m) {
       .def("all", &All<StringArray>)
       .def("__repr__", &ReprDunder<StringArray>)
       .def("__getitem__", &GetItemDunder<StringArray>)
-      .def("__eq__", &EqDunder<StringArray>)
-      .def("isna", &IsNA<StringArray>)
-      .def("take", &Take<StringArray>)
-      .def("copy", &Copy<StringArray>)
-      .def("fillna", &FillNA<StringArray>)
-      .def("dropna", &DropNA<StringArray>)
-      .def("interpolate", &Interpolate<StringArray>)
-      .def("unique", &Unique<StringArray>)
-      .def("factorize", &Factorize<StringArray>)
-      .def("_pad_or_backfill", &PadOrBackfill<StringArray>)
+      .def("__eq__", &Compare<CompareEq, StringArray>, kReleaseGIL)
+      .def("__eq__", &CompareScalar<CompareEq, StringArray>, kReleaseGIL)
+      .def("__ne__", &Compare<CompareNe, StringArray>, kReleaseGIL)
+      .def("__ne__", &CompareScalar<CompareNe, StringArray>, kReleaseGIL)
+      .def("__lt__", &Compare<CompareLt, StringArray>, kReleaseGIL)
+      .def("__lt__", &CompareScalar<CompareLt, StringArray>, kReleaseGIL)
+      .def("__le__", &Compare<CompareLe, StringArray>, kReleaseGIL)
+      .def("__le__", &CompareScalar<CompareLe, StringArray>, kReleaseGIL)
+      .def("__gt__", &Compare<CompareGt, StringArray>, kReleaseGIL)
+      .def("__gt__", &CompareScalar<CompareGt, StringArray>, kReleaseGIL)
+      .def("__ge__", &Compare<CompareGe, StringArray>, kReleaseGIL)
+      .def("__ge__", &CompareScalar<CompareGe, StringArray>, kReleaseGIL)
+      .def("isna", &IsNA<StringArray>, kReleaseGIL)
+      .def("take", &Take<StringArray>, nb::arg("indices"),
+           nb::arg("allow_fill") = false, nb::arg("fill_value") = nb::none())
+      .def("copy", &Copy<StringArray>, nb::arg("deep") = true, kReleaseGIL)
+      .def("fillna", &FillNA<StringArray>, kReleaseGIL)
+      .def("dropna", &DropNA<StringArray>, kReleaseGIL)
+      .def("interpolate", &Interpolate<StringArray>, kReleaseGIL)
+      .def("unique", &Unique<StringArray>, nb::arg("sort") = false, kReleaseGIL)
+      .def("argsort", &ArgSort<StringArray>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("sort", &Sort<StringArray>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("topk", &TopK<StringArray>, nb::arg("k"), nb::arg("largest") = true,
+           kReleaseGIL)
+      .def("factorize", &Factorize<StringArray>,
+           nb::arg("size_hint") = nb::none(), kReleaseGIL)
+      .def("_pad_or_backfill", &PadOrBackfill<StringArray>, kReleaseGIL)
       .def("_from_sequence", &FromSequence<StringArray>)
-      .def("_from_factorized", &FromFactorized<StringArray>)
+      .def("_from_factorized", &FromFactorized<StringArray>, kReleaseGIL)
       .def("to_pylist", &ToPyList<StringArray>)
-      .def("_concat_same_type", &ConcatSameType<StringArray>)
+      .def("_concat_same_type", &ConcatSameType<StringArray>,
+           nb::arg("to_concat") = nb::none())
+      .def("__arrow_c_schema__", &ArrowCSchema<StringArray>)
+      .def("__arrow_c_array__", &ArrowCArray<StringArray>,
+           nb::arg("requested_schema") = nb::none())
+      .def_static("from_arrow", &FromArrow<StringArray>)
 
       // string-specific algorithms
-      .def("len", &Len<StringArray>)
-      .def("lower", &Lower)
-      .def("upper", &Upper)
-      .def("capitalize", &Capitalize)
-      .def("isalnum", &IsAlnum)
-      .def("isalpha", &IsAlpha)
-      .def("isdigit", &IsDigit)
-      .def("isspace", &IsSpace)
-      .def("islower", &IsLower)
-      .def("isupper", &IsUpper);
+      .def("len", &Len<StringArray>, kReleaseGIL)
+      .def("lower", &Lower, kReleaseGIL)
+      .def("upper", &Upper, kReleaseGIL)
+      .def("capitalize", &Capitalize, kReleaseGIL)
+      .def("isalnum", &IsAlnum, kReleaseGIL)
+      .def("isalpha", &IsAlpha, kReleaseGIL)
+      .def("isdigit", &IsDigit, kReleaseGIL)
+      .def("isspace", &IsSpace, kReleaseGIL)
+      .def("islower", &IsLower, kReleaseGIL)
+      .def("isupper", &IsUpper, kReleaseGIL)
+      .def("dictionary_encode", &DictionaryEncode, kReleaseGIL)
+      .def("to_string_view", &ToStringView, kReleaseGIL);
 
   nb::class_<ExtensionDtype<StringArray>>(m, "StringDtype")
       .def("__str__", &ExtensionDtype<StringArray>::Str)
@@ -141,4 +289,420 @@ NB_MODULE(nanopandas_ext, m) {
       .def_prop_ro("is_boolean", &ExtensionDtype<StringArray>::IsBoolean)
       .def_prop_ro("_can_hold_na", &ExtensionDtype<StringArray>::CanHoldNA)
       .def_prop_ro("_is_immutable", &ExtensionDtype<StringArray>::IsImmutable);
+
+  // String views hold 16 bytes per row that inline short strings and point
+  // into the data of the arrays they were built from for longer ones
+  nb::class_<StringViewArray, ExtensionArray>(m, "StringViewArray")
+      .def("__init__", &InitStringViewArray, nb::arg("values"))
+      .def("__len__", &LenDunder<StringViewArray>)
+      .def_prop_ro("nbytes", &Nbytes<StringViewArray>)
+      .def_prop_ro("shape", &Shape<StringViewArray>)
+      .def_prop_ro("size", &Size<StringViewArray>)
+      .def_prop_ro("null_count", &NullCount<StringViewArray>)
+      .def_prop_ro("dtype", &StringViewDtype)
+      .def("__getitem__", &StringViewGetItemDunder)
+      .def("__eq__", &StringViewCompare<CompareEq>, kReleaseGIL)
+      .def("__eq__", &StringViewCompareScalar<CompareEq>, kReleaseGIL)
+      .def("__ne__", &StringViewCompare<CompareNe>, kReleaseGIL)
+      .def("__ne__", &StringViewCompareScalar<CompareNe>, kReleaseGIL)
+      .def("__lt__", &StringViewCompare<CompareLt>, kReleaseGIL)
+      .def("__lt__", &StringViewCompareScalar<CompareLt>, kReleaseGIL)
+      .def("__le__", &StringViewCompare<CompareLe>, kReleaseGIL)
+      .def("__le__", &StringViewCompareScalar<CompareLe>, kReleaseGIL)
+      .def("__gt__", &StringViewCompare<CompareGt>, kReleaseGIL)
+      .def("__gt__", &StringViewCompareScalar<CompareGt>, kReleaseGIL)
+      .def("__ge__", &StringViewCompare<CompareGe>, kReleaseGIL)
+      .def("__ge__", &StringViewCompareScalar<CompareGe>, kReleaseGIL)
+      .def("isna", &IsNA<StringViewArray>, kReleaseGIL)
+      .def("take", &Take<StringViewArray>, nb::arg("indices"),
+           nb::arg("allow_fill") = false, nb::arg("fill_value") = nb::none())
+      .def("unique", &Unique<StringViewArray>, nb::arg("sort") = false,
+           kReleaseGIL)
+      .def("argsort", &ArgSort<StringViewArray>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("sort", &Sort<StringViewArray>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("factorize", &Factorize<StringViewArray>,
+           nb::arg("size_hint") = nb::none(), kReleaseGIL)
+      .def("to_pylist", &ToPyList<StringViewArray>)
+      .def("to_string_array", &StringViewToStringArray, kReleaseGIL)
+      .def("to_numpy", &StringViewToNumpy, nb::arg("dtype") = nb::none(),
+           nb::arg("copy") = false, nb::arg("na_value") = nb::none());
+
+  // Dictionary encoded strings keep int32 codes into a dictionary of values,
+  // so that string kernels only run once per distinct value
+  nb::class_<DictionaryStringArray, ExtensionArray>(m, "DictionaryStringArray")
+      .def_static("from_factorized", &DictionaryFromFactorized,
+                  nb::arg("codes"), nb::arg("dictionary"), kReleaseGIL)
+      .def("__len__", &LenDunder<DictionaryStringArray>)
+      .def_prop_ro("nbytes", &DictionaryNbytes)
+      .def_prop_ro("shape", &Shape<DictionaryStringArray>)
+      .def_prop_ro("size", &Size<DictionaryStringArray>)
+      .def_prop_ro("null_count", &NullCount<DictionaryStringArray>)
+      .def_prop_ro("codes", &DictionaryCodes, kReleaseGIL)
+      .def_prop_ro("dictionary", &DictionaryValues)
+      .def("__getitem__", &DictionaryGetItemDunder)
+      .def("__eq__",
+           &DictionaryWise<&CompareScalar<CompareEq, StringArray>,
+                           std::string_view>,
+           kReleaseGIL)
+      .def("__ne__",
+           &DictionaryWise<&CompareScalar<CompareNe, StringArray>,
+                           std::string_view>,
+           kReleaseGIL)
+      .def("__lt__",
+           &DictionaryWise<&CompareScalar<CompareLt, StringArray>,
+                           std::string_view>,
+           kReleaseGIL)
+      .def("__le__",
+           &DictionaryWise<&CompareScalar<CompareLe, StringArray>,
+                           std::string_view>,
+           kReleaseGIL)
+      .def("__gt__",
+           &DictionaryWise<&CompareScalar<CompareGt, StringArray>,
+                           std::string_view>,
+           kReleaseGIL)
+      .def("__ge__",
+           &DictionaryWise<&CompareScalar<CompareGe, StringArray>,
+                           std::string_view>,
+           kReleaseGIL)
+      .def("isna", &IsNA<DictionaryStringArray>, kReleaseGIL)
+      .def("unique", &DictionaryUnique, nb::arg("sort") = false, kReleaseGIL)
+      .def("argsort", &ArgSort<DictionaryStringArray>,
+           nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("sort", &Sort<DictionaryStringArray>,
+           nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("decode", &DictionaryDecode, kReleaseGIL)
+      .def("to_pylist", &DictionaryToPyList)
+      .def("len", &DictionaryWise<&Len<StringArray>>, kReleaseGIL)
+      .def("lower", &DictionaryWise<&Lower>, kReleaseGIL)
+      .def("upper", &DictionaryWise<&Upper>, kReleaseGIL)
+      .def("capitalize", &DictionaryWise<&Capitalize>, kReleaseGIL)
+      .def("isalnum", &DictionaryWise<&IsAlnum>, kReleaseGIL)
+      .def("isalpha", &DictionaryWise<&IsAlpha>, kReleaseGIL)
+      .def("isdigit", &DictionaryWise<&IsDigit>, kReleaseGIL)
+      .def("isspace", &DictionaryWise<&IsSpace>, kReleaseGIL)
+      .def("islower", &DictionaryWise<&IsLower>, kReleaseGIL)
+      .def("isupper", &DictionaryWise<&IsUpper>, kReleaseGIL);
+
+  // Chunked arrays hold a sequence of arrays of the same type, so that
+  // concatenation only has to copy chunk references. They offer the same
+  // methods as the plain arrays
+  nb::class_<ChunkedArray<BoolArray>>(m, "ChunkedBoolArray")
+      .def(nb::init<const std::vector<const BoolArray *> &>(),
+           nb::arg("chunks"))
+      .def("__len__", &ChunkedLenDunder<BoolArray>)
+      .def_prop_ro("dtype", &ChunkedDtype<BoolArray>)
+      .def_prop_ro("nbytes", &ChunkedNbytes<BoolArray>)
+      .def_prop_ro("shape", &ChunkedShape<BoolArray>)
+      .def_prop_ro("size", &ChunkedLenDunder<BoolArray>)
+      .def_prop_ro("null_count", &ChunkedNullCount<BoolArray>)
+      .def_prop_ro("num_chunks", &NumChunks<BoolArray>)
+      .def_prop_ro("chunks", &Chunks<BoolArray>)
+      .def("any", &ChunkedAny<BoolArray>)
+      .def("all", &ChunkedAll<BoolArray>)
+      .def("__repr__", &ChunkedReprDunder<BoolArray>)
+      .def("__getitem__", &ChunkedGetItemDunder<BoolArray>)
+      .def("__eq__", &ChunkedCompare<CompareEq, BoolArray>, kReleaseGIL)
+      .def("__eq__", &ChunkedCompare<CompareEq, BoolArray, BoolArray>,
+           kReleaseGIL)
+      .def("__eq__", &ChunkedCompareScalar<CompareEq, BoolArray>, kReleaseGIL)
+      .def("__ne__", &ChunkedCompare<CompareNe, BoolArray>, kReleaseGIL)
+      .def("__ne__", &ChunkedCompare<CompareNe, BoolArray, BoolArray>,
+           kReleaseGIL)
+      .def("__ne__", &ChunkedCompareScalar<CompareNe, BoolArray>, kReleaseGIL)
+      .def("__lt__", &ChunkedCompare<CompareLt, BoolArray>, kReleaseGIL)
+      .def("__lt__", &ChunkedCompare<CompareLt, BoolArray, BoolArray>,
+           kReleaseGIL)
+      .def("__lt__", &ChunkedCompareScalar<CompareLt, BoolArray>, kReleaseGIL)
+      .def("__le__", &ChunkedCompare<CompareLe, BoolArray>, kReleaseGIL)
+      .def("__le__", &ChunkedCompare<CompareLe, BoolArray, BoolArray>,
+           kReleaseGIL)
+      .def("__le__", &ChunkedCompareScalar<CompareLe, BoolArray>, kReleaseGIL)
+      .def("__gt__", &ChunkedCompare<CompareGt, BoolArray>, kReleaseGIL)
+      .def("__gt__", &ChunkedCompare<CompareGt, BoolArray, BoolArray>,
+           kReleaseGIL)
+      .def("__gt__", &ChunkedCompareScalar<CompareGt, BoolArray>, kReleaseGIL)
+      .def("__ge__", &ChunkedCompare<CompareGe, BoolArray>, kReleaseGIL)
+      .def("__ge__", &ChunkedCompare<CompareGe, BoolArray, BoolArray>,
+           kReleaseGIL)
+      .def("__ge__", &ChunkedCompareScalar<CompareGe, BoolArray>, kReleaseGIL)
+      .def("isna", &ChunkWise<&IsNA<BoolArray>, BoolArray>, kReleaseGIL)
+      .def("take", &ChunkedTake<BoolArray>, nb::arg("indices"),
+           nb::arg("allow_fill") = false, nb::arg("fill_value") = nb::none())
+      .def("copy", &ChunkWise<&Copy<BoolArray>, BoolArray, bool>,
+           nb::arg("deep") = true, kReleaseGIL)
+      .def("fillna",
+           &ChunkWise<&FillNA<BoolArray>, BoolArray, BoolArray::ScalarT>,
+           kReleaseGIL)
+      .def("dropna", &ChunkWise<&DropNA<BoolArray>, BoolArray>, kReleaseGIL)
+      .def("interpolate", &ChunkedInterpolate<BoolArray>, kReleaseGIL)
+      .def("unique", &ChunkedUnique<BoolArray>, nb::arg("sort") = false,
+           kReleaseGIL)
+      .def("argsort", &ChunkedArgSort<BoolArray>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("sort", &ChunkedSort<BoolArray>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("factorize", &ChunkedFactorize<BoolArray>,
+           nb::arg("size_hint") = nb::none(), kReleaseGIL)
+      .def("_pad_or_backfill", &ChunkedPadOrBackfill<BoolArray>, kReleaseGIL)
+      .def("_from_sequence", &ChunkedFromSequence<BoolArray>)
+      .def("_from_factorized", &ChunkedFromFactorized<BoolArray>, kReleaseGIL)
+      .def("to_pylist", &ChunkedToPyList<BoolArray>)
+      .def("_concat_same_type", &ChunkedConcatSameType<BoolArray>,
+           nb::arg("to_concat") = nb::none())
+      .def("combine_chunks", &CombineChunks<BoolArray>, kReleaseGIL)
+      .def("__arrow_c_schema__", &ChunkedArrowCSchema<BoolArray>)
+      .def("__arrow_c_array__", &ChunkedArrowCArray<BoolArray>,
+           nb::arg("requested_schema") = nb::none())
+      .def_static("from_arrow", &ChunkedFromArrow<BoolArray>)
+      .def("to_numpy", &ChunkedToNumpy<BoolArray>,
+           nb::arg("dtype") = nb::none(), nb::arg("copy") = false,
+           nb::arg("na_value") = nb::none())
+      .def("to_numpy_masked", &ChunkedToNumpyMasked<BoolArray>)
+      .def("__array__", &ChunkedArrayDunder<BoolArray>,
+           nb::arg("dtype") = nb::none(), nb::arg("copy") = nb::none())
+
+      // Kleene logical operators
+      .def("__and__", &ChunkedLogical<LogicalAnd, BoolArray>, kReleaseGIL)
+      .def("__and__", &ChunkedLogical<LogicalAnd, BoolArray, BoolArray>,
+           kReleaseGIL)
+      .def("__and__", &ChunkedLogicalScalar<LogicalAnd, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__rand__", &ChunkedLogicalScalar<LogicalAnd, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__or__", &ChunkedLogical<LogicalOr, BoolArray>, kReleaseGIL)
+      .def("__or__", &ChunkedLogical<LogicalOr, BoolArray, BoolArray>,
+           kReleaseGIL)
+      .def("__or__", &ChunkedLogicalScalar<LogicalOr, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__ror__", &ChunkedLogicalScalar<LogicalOr, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__xor__", &ChunkedLogical<LogicalXor, BoolArray>, kReleaseGIL)
+      .def("__xor__", &ChunkedLogical<LogicalXor, BoolArray, BoolArray>,
+           kReleaseGIL)
+      .def("__xor__", &ChunkedLogicalScalar<LogicalXor, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__rxor__", &ChunkedLogicalScalar<LogicalXor, BoolArray>,
+           nb::arg("other").none(), kReleaseGIL)
+      .def("__invert__", &ChunkWise<&InvertDunder<BoolArray>, BoolArray>,
+           kReleaseGIL);
+
+  nb::class_<ChunkedArray<Int64Array>>(m, "ChunkedInt64Array")
+      .def(nb::init<const std::vector<const Int64Array *> &>(),
+           nb::arg("chunks"))
+      .def("__len__", &ChunkedLenDunder<Int64Array>)
+      .def_prop_ro("dtype", &ChunkedDtype<Int64Array>)
+      .def_prop_ro("nbytes", &ChunkedNbytes<Int64Array>)
+      .def_prop_ro("shape", &ChunkedShape<Int64Array>)
+      .def_prop_ro("size", &ChunkedLenDunder<Int64Array>)
+      .def_prop_ro("null_count", &ChunkedNullCount<Int64Array>)
+      .def_prop_ro("num_chunks", &NumChunks<Int64Array>)
+      .def_prop_ro("chunks", &Chunks<Int64Array>)
+      .def("any", &ChunkedAny<Int64Array>)
+      .def("all", &ChunkedAll<Int64Array>)
+      .def("__repr__", &ChunkedReprDunder<Int64Array>)
+      .def("__getitem__", &ChunkedGetItemDunder<Int64Array>)
+      .def("__eq__", &ChunkedCompare<CompareEq, Int64Array>, kReleaseGIL)
+      .def("__eq__", &ChunkedCompare<CompareEq, Int64Array, Int64Array>,
+           kReleaseGIL)
+      .def("__eq__", &ChunkedCompareScalar<CompareEq, Int64Array>, kReleaseGIL)
+      .def("__ne__", &ChunkedCompare<CompareNe, Int64Array>, kReleaseGIL)
+      .def("__ne__", &ChunkedCompare<CompareNe, Int64Array, Int64Array>,
+           kReleaseGIL)
+      .def("__ne__", &ChunkedCompareScalar<CompareNe, Int64Array>, kReleaseGIL)
+      .def("__lt__", &ChunkedCompare<CompareLt, Int64Array>, kReleaseGIL)
+      .def("__lt__", &ChunkedCompare<CompareLt, Int64Array, Int64Array>,
+           kReleaseGIL)
+      .def("__lt__", &ChunkedCompareScalar<CompareLt, Int64Array>, kReleaseGIL)
+      .def("__le__", &ChunkedCompare<CompareLe, Int64Array>, kReleaseGIL)
+      .def("__le__", &ChunkedCompare<CompareLe, Int64Array, Int64Array>,
+           kReleaseGIL)
+      .def("__le__", &ChunkedCompareScalar<CompareLe, Int64Array>, kReleaseGIL)
+      .def("__gt__", &ChunkedCompare<CompareGt, Int64Array>, kReleaseGIL)
+      .def("__gt__", &ChunkedCompare<CompareGt, Int64Array, Int64Array>,
+           kReleaseGIL)
+      .def("__gt__", &ChunkedCompareScalar<CompareGt, Int64Array>, kReleaseGIL)
+      .def("__ge__", &ChunkedCompare<CompareGe, Int64Array>, kReleaseGIL)
+      .def("__ge__", &ChunkedCompare<CompareGe, Int64Array, Int64Array>,
+           kReleaseGIL)
+      .def("__ge__", &ChunkedCompareScalar<CompareGe, Int64Array>, kReleaseGIL)
+      .def("isna", &ChunkWise<&IsNA<Int64Array>, Int64Array>, kReleaseGIL)
+      .def("take", &ChunkedTake<Int64Array>, nb::arg("indices"),
+           nb::arg("allow_fill") = false, nb::arg("fill_value") = nb::none())
+      .def("copy", &ChunkWise<&Copy<Int64Array>, Int64Array, bool>,
+           nb::arg("deep") = true, kReleaseGIL)
+      .def("fillna",
+           &ChunkWise<&FillNA<Int64Array>, Int64Array, Int64Array::ScalarT>,
+           kReleaseGIL)
+      .def("dropna", &ChunkWise<&DropNA<Int64Array>, Int64Array>, kReleaseGIL)
+      .def("interpolate", &ChunkedInterpolate<Int64Array>, kReleaseGIL)
+      .def("unique", &ChunkedUnique<Int64Array>, nb::arg("sort") = false,
+           kReleaseGIL)
+      .def("argsort", &ChunkedArgSort<Int64Array>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("sort", &ChunkedSort<Int64Array>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("topk", &ChunkedTopK<Int64Array>, nb::arg("k"),
+           nb::arg("largest") = true, kReleaseGIL)
+      .def("factorize", &ChunkedFactorize<Int64Array>,
+           nb::arg("size_hint") = nb::none(), kReleaseGIL)
+      .def("_pad_or_backfill", &ChunkedPadOrBackfill<Int64Array>, kReleaseGIL)
+      .def("_from_sequence", &ChunkedFromSequence<Int64Array>)
+      .def("_from_factorized", &ChunkedFromFactorized<Int64Array>, kReleaseGIL)
+      .def("to_pylist", &ChunkedToPyList<Int64Array>)
+      .def("_concat_same_type", &ChunkedConcatSameType<Int64Array>,
+           nb::arg("to_concat") = nb::none())
+      .def("combine_chunks", &CombineChunks<Int64Array>, kReleaseGIL)
+      .def("__arrow_c_schema__", &ChunkedArrowCSchema<Int64Array>)
+      .def("__arrow_c_array__", &ChunkedArrowCArray<Int64Array>,
+           nb::arg("requested_schema") = nb::none())
+      .def_static("from_arrow", &ChunkedFromArrow<Int64Array>)
+      .def("to_numpy", &ChunkedToNumpy<Int64Array>,
+           nb::arg("dtype") = nb::none(), nb::arg("copy") = false,
+           nb::arg("na_value") = nb::none())
+      .def("to_numpy_masked", &ChunkedToNumpyMasked<Int64Array>)
+      .def("__array__", &ChunkedArrayDunder<Int64Array>,
+           nb::arg("dtype") = nb::none(), nb::arg("copy") = nb::none())
+
+      // integral-specific algorithms
+      .def("sum", &ChunkedSum<Int64Array>, nb::arg("skipna") = true,
+           nb::arg("min_count") = 0, kReleaseGIL)
+      .def("min", &ChunkedMin<Int64Array>, nb::arg("skipna") = true,
+           kReleaseGIL)
+      .def("max", &ChunkedMax<Int64Array>, nb::arg("skipna") = true,
+           kReleaseGIL)
+
+      // arithmetic, chunk by chunk
+      .def("__add__", &ChunkedArithmetic<ArithmeticAdd, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__add__", &ChunkedArithmetic<ArithmeticAdd, Int64Array, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__add__", &ChunkedArithmeticScalar<ArithmeticAdd, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__radd__", &ChunkedArithmeticScalar<ArithmeticAdd, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__sub__", &ChunkedArithmetic<ArithmeticSub, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__sub__", &ChunkedArithmetic<ArithmeticSub, Int64Array, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__sub__", &ChunkedArithmeticScalar<ArithmeticSub, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__rsub__",
+           &ChunkedReflectedArithmeticScalar<ArithmeticSub, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__mul__", &ChunkedArithmetic<ArithmeticMul, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__mul__", &ChunkedArithmetic<ArithmeticMul, Int64Array, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__mul__", &ChunkedArithmeticScalar<ArithmeticMul, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__rmul__", &ChunkedArithmeticScalar<ArithmeticMul, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__floordiv__", &ChunkedArithmetic<ArithmeticFloorDiv, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__floordiv__",
+           &ChunkedArithmetic<ArithmeticFloorDiv, Int64Array, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__floordiv__",
+           &ChunkedArithmeticScalar<ArithmeticFloorDiv, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__rfloordiv__",
+           &ChunkedReflectedArithmeticScalar<ArithmeticFloorDiv, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__mod__", &ChunkedArithmetic<ArithmeticMod, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__mod__", &ChunkedArithmetic<ArithmeticMod, Int64Array, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__mod__", &ChunkedArithmeticScalar<ArithmeticMod, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__rmod__",
+           &ChunkedReflectedArithmeticScalar<ArithmeticMod, Int64Array>,
+           nb::arg("other"), nb::arg("check_overflow") = true, kReleaseGIL)
+      .def("__neg__", &ChunkWise<&Negate<Int64Array>, Int64Array>, kReleaseGIL);
+
+  nb::class_<ChunkedArray<StringArray>>(m, "ChunkedStringArray")
+      .def(nb::init<const std::vector<const StringArray *> &>(),
+           nb::arg("chunks"))
+      .def("__len__", &ChunkedLenDunder<StringArray>)
+      .def_prop_ro("dtype", &ChunkedDtype<StringArray>)
+      .def_prop_ro("nbytes", &ChunkedNbytes<StringArray>)
+      .def_prop_ro("shape", &ChunkedShape<StringArray>)
+      .def_prop_ro("size", &ChunkedLenDunder<StringArray>)
+      .def_prop_ro("null_count", &ChunkedNullCount<StringArray>)
+      .def_prop_ro("num_chunks", &NumChunks<StringArray>)
+      .def_prop_ro("chunks", &Chunks<StringArray>)
+      .def("any", &ChunkedAny<StringArray>)
+      .def("all", &ChunkedAll<StringArray>)
+      .def("__repr__", &ChunkedReprDunder<StringArray>)
+      .def("__getitem__", &ChunkedGetItemDunder<StringArray>)
+      .def("__eq__", &ChunkedCompare<CompareEq, StringArray>, kReleaseGIL)
+      .def("__eq__", &ChunkedCompare<CompareEq, StringArray, StringArray>,
+           kReleaseGIL)
+      .def("__eq__", &ChunkedCompareScalar<CompareEq, StringArray>, kReleaseGIL)
+      .def("__ne__", &ChunkedCompare<CompareNe, StringArray>, kReleaseGIL)
+      .def("__ne__", &ChunkedCompare<CompareNe, StringArray, StringArray>,
+           kReleaseGIL)
+      .def("__ne__", &ChunkedCompareScalar<CompareNe, StringArray>, kReleaseGIL)
+      .def("__lt__", &ChunkedCompare<CompareLt, StringArray>, kReleaseGIL)
+      .def("__lt__", &ChunkedCompare<CompareLt, StringArray, StringArray>,
+           kReleaseGIL)
+      .def("__lt__", &ChunkedCompareScalar<CompareLt, StringArray>, kReleaseGIL)
+      .def("__le__", &ChunkedCompare<CompareLe, StringArray>, kReleaseGIL)
+      .def("__le__", &ChunkedCompare<CompareLe, StringArray, StringArray>,
+           kReleaseGIL)
+      .def("__le__", &ChunkedCompareScalar<CompareLe, StringArray>, kReleaseGIL)
+      .def("__gt__", &ChunkedCompare<CompareGt, StringArray>, kReleaseGIL)
+      .def("__gt__", &ChunkedCompare<CompareGt, StringArray, StringArray>,
+           kReleaseGIL)
+      .def("__gt__", &ChunkedCompareScalar<CompareGt, StringArray>, kReleaseGIL)
+      .def("__ge__", &ChunkedCompare<CompareGe, StringArray>, kReleaseGIL)
+      .def("__ge__", &ChunkedCompare<CompareGe, StringArray, StringArray>,
+           kReleaseGIL)
+      .def("__ge__", &ChunkedCompareScalar<CompareGe, StringArray>, kReleaseGIL)
+      .def("isna", &ChunkWise<&IsNA<StringArray>, StringArray>, kReleaseGIL)
+      .def("take", &ChunkedTake<StringArray>, nb::arg("indices"),
+           nb::arg("allow_fill") = false, nb::arg("fill_value") = nb::none())
+      .def("copy", &ChunkWise<&Copy<StringArray>, StringArray, bool>,
+           nb::arg("deep") = true, kReleaseGIL)
+      .def("fillna",
+           &ChunkWise<&FillNA<StringArray>, StringArray, StringArray::ScalarT>,
+           kReleaseGIL)
+      .def("dropna", &ChunkWise<&DropNA<StringArray>, StringArray>, kReleaseGIL)
+      .def("interpolate", &ChunkedInterpolate<StringArray>, kReleaseGIL)
+      .def("unique", &ChunkedUnique<StringArray>, nb::arg("sort") = false,
+           kReleaseGIL)
+      .def("argsort", &ChunkedArgSort<StringArray>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("sort", &ChunkedSort<StringArray>, nb::arg("ascending") = true,
+           nb::arg("na_position") = "last", kReleaseGIL)
+      .def("topk", &ChunkedTopK<StringArray>, nb::arg("k"),
+           nb::arg("largest") = true, kReleaseGIL)
+      .def("factorize", &ChunkedFactorize<StringArray>,
+           nb::arg("size_hint") = nb::none(), kReleaseGIL)
+      .def("_pad_or_backfill", &ChunkedPadOrBackfill<StringArray>, kReleaseGIL)
+      .def("_from_sequence", &ChunkedFromSequence<StringArray>)
+      .def("_from_factorized", &ChunkedFromFactorized<StringArray>, kReleaseGIL)
+      .def("to_pylist", &ChunkedToPyList<StringArray>)
+      .def("_concat_same_type", &ChunkedConcatSameType<StringArray>,
+           nb::arg("to_concat") = nb::none())
+      .def("combine_chunks", &CombineChunks<StringArray>, kReleaseGIL)
+      .def("__arrow_c_schema__", &ChunkedArrowCSchema<StringArray>)
+      .def("__arrow_c_array__", &ChunkedArrowCArray<StringArray>,
+           nb::arg("requested_schema") = nb::none())
+      .def_static("from_arrow", &ChunkedFromArrow<StringArray>)
+
+      // string-specific algorithms
+      .def("len", &ChunkWise<&Len<StringArray>, StringArray>, kReleaseGIL)
+      .def("lower", &ChunkWise<&Lower, StringArray>, kReleaseGIL)
+      .def("upper", &ChunkWise<&Upper, StringArray>, kReleaseGIL)
+      .def("capitalize", &ChunkWise<&Capitalize, StringArray>, kReleaseGIL)
+      .def("isalnum", &ChunkWise<&IsAlnum, StringArray>, kReleaseGIL)
+      .def("isalpha", &ChunkWise<&IsAlpha, StringArray>, kReleaseGIL)
+      .def("isdigit", &ChunkWise<&IsDigit, StringArray>, kReleaseGIL)
+      .def("isspace", &ChunkWise<&IsSpace, StringArray>, kReleaseGIL)
+      .def("islower", &ChunkWise<&IsLower, StringArray>, kReleaseGIL)
+      .def("isupper", &ChunkWise<&IsUpper, StringArray>, kReleaseGIL);
 }
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "array_types.hpp"
+
+// The 16 byte layout of Arrow's string view type. The size comes first,
+// followed either by the whole string, zero padded, when it is at most 12
+// bytes long, or by its first four bytes, the index of the data buffer
+// holding it and its offset in there
+struct StringViewEntry {
+  int32_t size;
+  char prefix[4];
+  int32_t buffer_index;
+  int32_t offset;
+};
+static_assert(sizeof(StringViewEntry) == 16);
+
+constexpr int32_t kMaxInlineStringSize = 12;
+
+// Inline strings take up the 12 bytes after the size, running on from the
+// prefix into the buffer index and offset
+inline const char *InlineData(const StringViewEntry &view) {
+  return reinterpret_cast<const char *>(&view) + sizeof(view.size);
+}
+
+inline StringViewEntry MakeStringView(std::string_view value,
+                                      int32_t buffer_index, int32_t offset) {
+  StringViewEntry view{};
+  view.size = static_cast<int32_t>(value.size());
+  if (view.size <= kMaxInlineStringSize) {
+    std::memcpy(reinterpret_cast<char *>(&view) + sizeof(view.size),
+                value.data(), value.size());
+  } else {
+    std::memcpy(view.prefix, value.data(), sizeof(view.prefix));
+    view.buffer_index = buffer_index;
+    view.offset = offset;
+  }
+  return view;
+}
+
+// The character data that long strings point into. Buffers are slices of
+// the data of the string arrays the views were built from, so building
+// views never copies any characters
+struct StringViewBuffers {
+  std::vector<std::shared_ptr<const StringArray>> owners;
+  std::vector<const char *> data;
+};
+
+// A string array made up of fixed width StringViewEntry values, so that
+// take and filter only gather 16 bytes per row and most comparisons are
+// decided by the size and prefix stored inline. The pinned nanoarrow has no
+// view type, so the entries are held as fixed size binary data whose width
+// is set on the array view, as a schema would otherwise do
+class StringViewArray : public ExtensionArray {
+public:
+  using ScalarT = std::string_view;
+  static constexpr enum ArrowType ArrowT = NANOARROW_TYPE_FIXED_SIZE_BINARY;
+
+  StringViewArray(nanoarrow::UniqueArray &&views,
+                  std::shared_ptr<const StringViewBuffers> buffers)
+      : buffers_(std::move(buffers)) {
+    SetArray(std::move(views), ArrowT);
+    array_view_->layout.element_size_bits[1] = 8 * sizeof(StringViewEntry);
+    array_view_->buffer_views[1].size_bytes =
+        (array_view_->offset + array_view_->length) *
+        static_cast<int64_t>(sizeof(StringViewEntry));
+  }
+
+  const std::shared_ptr<const StringViewBuffers> &buffers() const {
+    return buffers_;
+  }
+
+  const StringViewEntry *views() const {
+    return static_cast<const StringViewEntry *>(
+               array_view_->buffer_views[1].data.data) +
+           array_view_->offset;
+  }
+
+  std::string_view Value(const StringViewEntry &view) const {
+    const char *data = view.size <= kMaxInlineStringSize
+                           ? InlineData(view)
+                           : buffers_->data[view.buffer_index] + view.offset;
+    return {data, static_cast<size_t>(view.size)};
+  }
+
+  std::string_view Value(int64_t i) const { return Value(views()[i]); }
+
+  // Returns a new array over rows [offset, offset + length) that shares
+  // both the views and the character data
+  StringViewArray Share(int64_t offset, int64_t length) const {
+    nanoarrow::UniqueArray views;
+    ShareArray(views.get(), offset, length);
+    return StringViewArray(std::move(views), buffers_);
+  }
+
+private:
+  std::shared_ptr<const StringViewBuffers> buffers_;
+};
+
+// The first 8 bytes hold the size and prefix, which tells most unequal
+// strings apart without looking at their characters. Inline strings are
+// zero padded, so the remaining 8 bytes settle those too. left_value and
+// right_value return the full strings and are only called for long ones
+template <typename LeftValue, typename RightValue>
+bool StringViewsEqual(const StringViewEntry &left,
+                      const StringViewEntry &right, LeftValue &&left_value,
+                      RightValue &&right_value) {
+  if (std::memcmp(&left, &right, 8) != 0) {
+    return false;
+  }
+  if (left.size <= kMaxInlineStringSize) {
+    return std::memcmp(InlineData(left) + 4, InlineData(right) + 4, 8) == 0;
+  }
+  return left_value().substr(4) == right_value().substr(4);
+}
+
+// Three way comparison by bytes. Prefixes are compared first, as they are
+// stored inline for short and long strings alike
+template <typename LeftValue, typename RightValue>
+int StringViewsCompare(const StringViewEntry &left,
+                       const StringViewEntry &right, LeftValue &&left_value,
+                       RightValue &&right_value) {
+  const auto prefix_size =
+      static_cast<size_t>(std::min({left.size, right.size, int32_t{4}}));
+  const int prefix_order = std::memcmp(left.prefix, right.prefix, prefix_size);
+  if (prefix_order != 0) {
+    return prefix_order;
+  }
+  return left_value().compare(right_value());
+}
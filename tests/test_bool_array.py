@@ -0,0 +1,151 @@
+import pytest
+
+import nanopandas as nanopd
+
+
+def test_constructor():
+    values = [True, None, False] * 30
+    arr = nanopd.BoolArray(values)
+    assert arr.to_pylist() == values
+    assert arr.null_count == 30
+
+
+def test_constructor_invalid_value():
+    with pytest.raises(TypeError, match="position 3"):
+        nanopd.BoolArray([True, False, None, "yes"])
+
+
+def test_from_arrow():
+    arr = nanopd.BoolArray([True, None, False])
+    result = nanopd.BoolArray.from_arrow(arr)
+    assert result.to_pylist() == [True, None, False]
+
+
+def test_from_arrow_pyarrow():
+    pa = pytest.importorskip("pyarrow")
+    arr = nanopd.BoolArray.from_arrow(pa.array([True, None, False]))
+    assert arr.to_pylist() == [True, None, False]
+    assert pa.array(arr).to_pylist() == [True, None, False]
+
+
+def test_to_numpy():
+    np = pytest.importorskip("numpy")
+    arr = nanopd.BoolArray([True, None, False])
+    assert arr.to_numpy(na_value=False).tolist() == [True, False, False]
+    assert arr.to_numpy().tolist() == [True, None, False]
+    assert np.asarray(arr[2:]).tolist() == [False]
+
+    values, mask = arr.to_numpy_masked()
+    assert values.dtype == np.bool_
+    assert mask.tolist() == [False, True, False]
+
+
+def test_to_numpy_dtype():
+    np = pytest.importorskip("numpy")
+    arr = nanopd.BoolArray([True, None, False])
+    result = arr.to_numpy(dtype="float64", copy=False, na_value=None)
+    assert result[0] == 1.0
+    assert np.isnan(result[1])
+    assert arr[2:].to_numpy(dtype=np.int8).tolist() == [0]
+
+    if np.lib.NumpyVersion(np.__version__) >= "2.0.0":
+        with pytest.raises(ValueError):
+            np.asarray(arr[2:], copy=False)
+
+
+def test_from_numpy():
+    np = pytest.importorskip("numpy")
+    values = np.arange(200) % 3 == 0
+    arr = nanopd.BoolArray.from_numpy(values, mask=np.arange(200) == 1)
+    expected = values.tolist()
+    expected[1] = None
+    assert arr.to_pylist() == expected
+
+
+def test_copy():
+    arr = nanopd.BoolArray([True, None, False, True, False, False, True, None, True])
+    assert arr.copy().to_pylist() == arr.to_pylist()
+    assert arr.copy(deep=False).to_pylist() == arr.to_pylist()
+
+
+def test_concat_same_type():
+    arr = nanopd.BoolArray([True, None, False])
+    result = nanopd.BoolArray._concat_same_type([arr[1:], arr, arr[:1]])
+    assert result.to_pylist() == [None, False, True, None, False, True]
+
+
+def test_take():
+    arr = nanopd.BoolArray([True, None, False])
+    assert arr.take([2, 0, 1]).to_pylist() == [False, True, None]
+    assert arr.take([0, -1], allow_fill=True).to_pylist() == [True, None]
+
+
+def test_eq():
+    arr = nanopd.BoolArray([True, None, False, False])
+    other = nanopd.BoolArray([True, True, True, None])
+    assert (arr == other).to_pylist() == [True, None, False, None]
+    assert (arr == False).to_pylist() == [False, None, True, True]  # noqa: E712
+    assert (arr[1:] == True).to_pylist() == [None, False, False]  # noqa: E712
+
+
+def test_comparisons():
+    arr = nanopd.BoolArray([False, False, True, True, None])
+    other = nanopd.BoolArray([False, True, False, True, True])
+    assert (arr != other).to_pylist() == [False, True, True, False, None]
+    assert (arr < other).to_pylist() == [False, True, False, False, None]
+    assert (arr <= other).to_pylist() == [True, True, False, True, None]
+    assert (arr > other).to_pylist() == [False, False, True, False, None]
+    assert (arr >= other).to_pylist() == [True, False, True, True, None]
+    assert (arr > False).to_pylist() == [False, False, True, True, None]  # noqa: E712
+
+
+def test_logical_kleene():
+    left = nanopd.BoolArray([True] * 3 + [False] * 3 + [None] * 3)
+    right = nanopd.BoolArray([True, False, None] * 3)
+    assert (left & right).to_pylist() == [
+        True, False, None, False, False, False, None, False, None
+    ]
+    assert (left | right).to_pylist() == [
+        True, True, True, True, False, None, True, None, None
+    ]
+    assert (left ^ right).to_pylist() == [
+        False, True, None, True, False, None, None, None, None
+    ]
+    assert (~left).to_pylist() == [False] * 3 + [True] * 3 + [None] * 3
+    assert (~left[1:5]).to_pylist() == [False, False, True, True]
+
+
+def test_logical_scalar():
+    arr = nanopd.BoolArray([True, False, None])
+    assert (arr & True).to_pylist() == [True, False, None]
+    assert (arr & None).to_pylist() == [None, False, None]
+    assert (None | arr).to_pylist() == [True, None, None]
+    assert (True ^ arr).to_pylist() == [False, True, None]
+
+
+def test_logical_large():
+    values = [i % 3 == 0 for i in range(100_000)]
+    arr = nanopd.BoolArray(values)
+    result = arr[1:] | arr[:-1]
+    assert result.null_count == 0
+    assert result.to_pylist() == [a or b for a, b in zip(values[1:], values)]
+
+
+def test_unique():
+    arr = nanopd.BoolArray([None, False, False, True, None, True])
+    assert arr.unique().to_pylist() == [False, True]
+    assert arr[3:].unique().to_pylist() == [True]
+    assert arr.unique(sort=True).to_pylist() == [False, True]
+
+
+def test_argsort():
+    arr = nanopd.BoolArray([True, None, False, True, False])
+    assert arr.argsort().to_pylist() == [2, 4, 0, 3, 1]
+    assert arr.argsort(ascending=False).to_pylist() == [0, 3, 2, 4, 1]
+    assert arr.sort(na_position="first").to_pylist() == [
+        None,
+        False,
+        False,
+        True,
+        True,
+    ]
@@ -0,0 +1,231 @@
+import pytest
+
+import nanopandas as nanopd
+
+
+def test_chunks():
+    arr = nanopd.ChunkedInt64Array(
+        [nanopd.Int64Array([1, None]), nanopd.Int64Array([]), nanopd.Int64Array([3])]
+    )
+    assert len(arr) == 3
+    assert arr.num_chunks == 3
+    assert arr.null_count == 1
+    assert str(arr.dtype) == "int64"
+    assert [chunk.to_pylist() for chunk in arr.chunks] == [[1, None], [], [3]]
+    assert arr.to_pylist() == [1, None, 3]
+
+
+def test_chunks_none():
+    with pytest.raises(TypeError, match="position 1"):
+        nanopd.ChunkedInt64Array([nanopd.Int64Array([1]), None])
+
+
+def test_concat_same_type_keeps_chunks():
+    left = nanopd.ChunkedStringArray([nanopd.StringArray(["a", None])])
+    right = nanopd.ChunkedStringArray(
+        [nanopd.StringArray(["b"]), nanopd.StringArray(["c", "d"])]
+    )
+    result = left._concat_same_type(right)
+    assert result.num_chunks == 3
+    assert result.to_pylist() == ["a", None, "b", "c", "d"]
+    assert left.to_pylist() == ["a", None]
+
+
+def test_concat_same_type_sequence():
+    chunked = nanopd.ChunkedInt64Array(
+        [nanopd.Int64Array([1]), nanopd.Int64Array([2, None])]
+    )
+    plain = nanopd.Int64Array([4, 5])
+    result = nanopd.ChunkedInt64Array._concat_same_type([chunked, plain, chunked])
+    assert result.num_chunks == 5
+    assert result.to_pylist() == [1, 2, None, 4, 5, 1, 2, None]
+
+    result = chunked._concat_same_type([plain])
+    assert result.to_pylist() == [1, 2, None, 4, 5]
+
+    with pytest.raises(TypeError):
+        nanopd.ChunkedInt64Array._concat_same_type([chunked, nanopd.BoolArray([True])])
+
+
+def test_to_pylist_strings():
+    arr = nanopd.ChunkedStringArray(
+        [nanopd.StringArray(["a", None]), nanopd.StringArray(["b", "a"])]
+    )
+    result = arr.to_pylist()
+    assert result == ["a", None, "b", "a"]
+    assert result[0] is result[3]
+
+
+def test_getitem():
+    arr = nanopd.ChunkedInt64Array(
+        [nanopd.Int64Array([1, 2]), nanopd.Int64Array([3, None, 5])]
+    )
+    assert arr[0] == 1
+    assert arr[2] == 3
+    assert arr[3] is None
+    assert arr[-1] == 5
+    with pytest.raises(IndexError):
+        arr[5]
+
+    result = arr[1:4]
+    assert result.num_chunks == 2
+    assert result.to_pylist() == [2, 3, None]
+    assert arr[3:].num_chunks == 1
+    assert arr[::2].to_pylist() == [1, 3, 5]
+
+
+def test_combine_chunks():
+    arr = nanopd.ChunkedStringArray(
+        [nanopd.StringArray(["foo", None]), nanopd.StringArray(["bar", "baz"])[1:]]
+    )
+    result = arr.combine_chunks()
+    assert isinstance(result, nanopd.StringArray)
+    assert result.to_pylist() == ["foo", None, "baz"]
+
+    arr = nanopd.ChunkedBoolArray(
+        [nanopd.BoolArray([True, None, False])[1:], nanopd.BoolArray([True])]
+    )
+    assert arr.combine_chunks().to_pylist() == [None, False, True]
+
+
+def test_chunk_wise_kernels():
+    arr = nanopd.ChunkedStringArray(
+        [nanopd.StringArray(["Foo", None]), nanopd.StringArray(["bar"])]
+    )
+    assert arr.upper().to_pylist() == ["FOO", None, "BAR"]
+    assert arr.len().to_pylist() == [3, None, 3]
+    assert arr.islower().to_pylist() == [False, None, True]
+    assert arr.isna().to_pylist() == [False, True, False]
+    assert arr.fillna("baz").to_pylist() == ["Foo", "baz", "bar"]
+    assert arr.dropna().to_pylist() == ["Foo", "bar"]
+    assert arr.copy().num_chunks == 2
+
+
+def test_reductions():
+    arr = nanopd.ChunkedInt64Array(
+        [nanopd.Int64Array([1, None]), nanopd.Int64Array([-4, 3])]
+    )
+    assert arr.sum() == 0
+    assert arr.sum(skipna=False) is None
+    assert arr.min() == -4
+    assert arr.max() == 3
+    assert arr.max(skipna=False) is None
+
+    # partial sums may overflow as long as the total does not
+    big = 2**63 - 1
+    arr = nanopd.ChunkedInt64Array(
+        [nanopd.Int64Array([big, 1]), nanopd.Int64Array([-2])]
+    )
+    assert arr.sum() == big - 1
+
+
+def test_getitem_gather():
+    arr = nanopd.ChunkedStringArray(
+        [nanopd.StringArray(["a", None]), nanopd.StringArray(["c", "d", "e"])]
+    )
+    mask = [True, False, False, True, True]
+    for indexer in (
+        nanopd.BoolArray(mask),
+        nanopd.ChunkedBoolArray(
+            [nanopd.BoolArray(mask[:3]), nanopd.BoolArray(mask[3:])]
+        ),
+    ):
+        result = arr[indexer]
+        assert isinstance(result, nanopd.ChunkedStringArray)
+        # masks filter each chunk on its own instead of combining them
+        assert result.num_chunks == 2
+        assert result.to_pylist() == ["a", "d", "e"]
+
+    with pytest.raises(IndexError):
+        arr[nanopd.BoolArray(mask[:4])]
+
+    assert arr[[4, 1, 0]].to_pylist() == ["e", None, "a"]
+    assert arr[::2].to_pylist() == ["a", "c", "e"]
+
+    np = pytest.importorskip("numpy")
+    result = arr[np.array(mask)]
+    assert result.num_chunks == 2
+    assert result.to_pylist() == ["a", "d", "e"]
+
+
+def test_binary_kernels():
+    left = nanopd.ChunkedInt64Array(
+        [nanopd.Int64Array([1, 2, 3]), nanopd.Int64Array([None, 5])]
+    )
+    right = nanopd.ChunkedInt64Array(
+        [nanopd.Int64Array([1]), nanopd.Int64Array([0, 3, 4, 6])]
+    )
+    result = left == right
+    assert result.num_chunks == 2
+    assert result.to_pylist() == [True, False, True, None, False]
+    assert (left < nanopd.Int64Array([2, 2, 2, 2, 2])).to_pylist() == [
+        True,
+        False,
+        False,
+        None,
+        False,
+    ]
+    assert (left + right).to_pylist() == [2, 2, 6, None, 11]
+    assert (left - 1).to_pylist() == [0, 1, 2, None, 4]
+    assert (10 - left).to_pylist() == [9, 8, 7, None, 5]
+    assert (-left).to_pylist() == [-1, -2, -3, None, -5]
+
+    flags = nanopd.ChunkedBoolArray(
+        [nanopd.BoolArray([True, None]), nanopd.BoolArray([False])]
+    )
+    assert (flags & nanopd.BoolArray([False, True, True])).to_pylist() == [
+        False,
+        None,
+        False,
+    ]
+    assert (flags | True).to_pylist() == [True, True, True]
+    assert (~flags).to_pylist() == [False, None, True]
+
+    with pytest.raises(ValueError):
+        left == nanopd.Int64Array([1])
+
+
+def test_combined_kernels():
+    arr = nanopd.ChunkedInt64Array(
+        [nanopd.Int64Array([3, None]), nanopd.Int64Array([1, 3])]
+    )
+    taken = arr.take([3, 0, -1], allow_fill=True)
+    assert isinstance(taken, nanopd.ChunkedInt64Array)
+    assert taken.to_pylist() == [3, 3, None]
+
+    assert arr.unique().to_pylist() == [3, 1]
+    codes, uniques = arr.factorize()
+    assert codes.to_pylist() == [0, -1, 1, 0]
+    assert isinstance(uniques, nanopd.ChunkedInt64Array)
+    assert arr._from_factorized(codes, uniques).to_pylist() == [3, None, 1, 3]
+
+    assert arr.argsort().to_pylist() == [2, 0, 3, 1]
+    assert arr.sort(ascending=False).to_pylist() == [3, 3, 1, None]
+    values, positions = arr.topk(1)
+    assert values.to_pylist() == [3]
+    assert positions.to_pylist() == [0]
+    assert arr._pad_or_backfill("pad").to_pylist() == [3, 3, 1, 3]
+    assert arr._from_sequence([7, None]).to_pylist() == [7, None]
+    assert repr(arr) == "ChunkedInt64Array\n[3, null, 1, 3]"
+    assert arr.nbytes == sum(chunk.nbytes for chunk in arr.chunks)
+    assert arr.shape == (4,)
+    assert arr.any() and not arr.all()
+
+
+def test_arrow_and_numpy():
+    arr = nanopd.ChunkedInt64Array(
+        [nanopd.Int64Array([1, 2]), nanopd.Int64Array([3])]
+    )
+    assert nanopd.Int64Array.from_arrow(arr).to_pylist() == [1, 2, 3]
+    assert nanopd.ChunkedInt64Array.from_arrow(arr).to_pylist() == [1, 2, 3]
+
+    np = pytest.importorskip("numpy")
+    assert arr.to_numpy().tolist() == [1, 2, 3]
+    flags = nanopd.ChunkedBoolArray([nanopd.BoolArray([True, None])])
+    values, mask = flags.to_numpy_masked()
+    assert mask.tolist() == [False, True]
+    assert np.asarray(arr).tolist() == [1, 2, 3]
+    assert arr.to_numpy(dtype="float64").dtype == np.float64
+    if np.lib.NumpyVersion(np.__version__) >= "2.0.0":
+        with pytest.raises(ValueError):
+            np.asarray(arr, copy=False)
@@ -0,0 +1,110 @@
+import pytest
+
+import nanopandas as nanopd
+
+
+def test_dictionary_encode():
+    arr = nanopd.StringArray(["foo", None, "bar", "foo", "bar"])
+    result = arr.dictionary_encode()
+    assert len(result) == 5
+    assert result.null_count == 1
+    assert result.codes.to_pylist() == [0, -1, 1, 0, 1]
+    assert result.dictionary.to_pylist() == ["foo", "bar"]
+    assert result.to_pylist() == ["foo", None, "bar", "foo", "bar"]
+    assert result.decode().to_pylist() == ["foo", None, "bar", "foo", "bar"]
+
+
+def test_from_factorized():
+    codes, uniques = nanopd.StringArray(["a", "b", None, "a"]).factorize()
+    result = nanopd.DictionaryStringArray.from_factorized(codes, uniques)
+    assert result.to_pylist() == ["a", "b", None, "a"]
+
+    with pytest.raises(IndexError):
+        nanopd.DictionaryStringArray.from_factorized(
+            nanopd.Int64Array([0, 2]), nanopd.StringArray(["a", "b"])
+        )
+
+    # only -1 marks a missing row; other negative codes are out of bounds
+    with pytest.raises(IndexError):
+        nanopd.DictionaryStringArray.from_factorized(
+            nanopd.Int64Array([0, -2]), nanopd.StringArray(["a", "b"])
+        )
+
+    with pytest.raises(ValueError):
+        nanopd.DictionaryStringArray.from_factorized(
+            nanopd.Int64Array([0]), nanopd.StringArray(["a", None])
+        )
+
+    # masked codes are never checked
+    np = pytest.importorskip("numpy")
+    codes = nanopd.Int64Array.from_numpy(
+        np.array([-5, 1]), mask=np.array([True, False])
+    )
+    result = nanopd.DictionaryStringArray.from_factorized(
+        codes, nanopd.StringArray(["a", "b"])
+    )
+    assert result.to_pylist() == [None, "b"]
+
+
+def test_getitem():
+    arr = nanopd.StringArray(["foo", None, "bar", "foo"]).dictionary_encode()
+    assert arr[0] == "foo"
+    assert arr[1] is None
+    assert arr[-1] == "foo"
+
+    result = arr[1:3]
+    assert result.to_pylist() == [None, "bar"]
+    assert result.codes.to_pylist() == [-1, 1]
+
+    with pytest.raises(IndexError):
+        arr[4]
+
+
+def test_string_kernels():
+    values = ["Foo", None, "bar", "FOO", "123", "Foo"]
+    arr = nanopd.StringArray(values)
+    encoded = arr.dictionary_encode()
+
+    assert encoded.lower().to_pylist() == arr.lower().to_pylist()
+    assert encoded.upper().to_pylist() == arr.upper().to_pylist()
+    assert encoded.capitalize().to_pylist() == arr.capitalize().to_pylist()
+    assert encoded.len().to_pylist() == arr.len().to_pylist()
+    assert encoded.isalpha().to_pylist() == arr.isalpha().to_pylist()
+    assert encoded.isdigit().to_pylist() == arr.isdigit().to_pylist()
+    assert encoded.isupper().to_pylist() == arr.isupper().to_pylist()
+    assert encoded.isna().to_pylist() == arr.isna().to_pylist()
+    assert (encoded == "Foo").to_pylist() == (arr == "Foo").to_pylist()
+    assert (encoded < "bar").to_pylist() == (arr < "bar").to_pylist()
+
+
+def test_unique():
+    arr = nanopd.StringArray(["b", None, "A", "a", "B", "b"]).dictionary_encode()
+    assert arr.unique().to_pylist() == ["b", "A", "a", "B"]
+    # lowercasing maps several dictionary entries onto the same value
+    assert arr.lower().unique().to_pylist() == ["b", "a"]
+    assert arr.lower().unique(sort=True).to_pylist() == ["a", "b"]
+    # entries no longer referenced by a slice are left out
+    assert arr[1:3].unique().to_pylist() == ["A"]
+
+
+def test_sort():
+    arr = nanopd.StringArray(["b", None, "A", "b", "a"]).dictionary_encode()
+    assert arr.argsort().to_pylist() == [2, 4, 0, 3, 1]
+    # lowercasing leaves equal entries in the dictionary, which tie
+    assert arr.lower().argsort().to_pylist() == [2, 4, 0, 3, 1]
+    result = arr.sort(ascending=False, na_position="first")
+    assert result.to_pylist() == [None, "b", "b", "a", "A"]
+    assert result.dictionary.to_pylist() == arr.dictionary.to_pylist()
+
+
+def test_to_pylist_shares_values():
+    result = nanopd.StringArray(["café", "x", "café"]).dictionary_encode()
+    values = result.to_pylist()
+    assert values == ["café", "x", "café"]
+    assert values[0] is values[2]
+
+
+def test_nbytes():
+    arr = nanopd.StringArray(["abcdefgh"] * 100)
+    encoded = arr.dictionary_encode()
+    assert encoded.nbytes < arr.nbytes
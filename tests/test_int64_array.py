@@ -0,0 +1,421 @@
+import os
+import signal
+import time
+
+import pytest
+
+import nanopandas as nanopd
+
+
+def test_constructor():
+    values = [1, None, -(2**63), 2**63 - 1] * 40
+    arr = nanopd.Int64Array(iter(values))
+    assert arr.to_pylist() == values
+    assert arr.null_count == 40
+
+    assert nanopd.Int64Array((1, 2)).null_count == 0
+
+
+def test_constructor_invalid_value():
+    with pytest.raises(TypeError, match="position 1"):
+        nanopd.Int64Array([1, "2"])
+
+    with pytest.raises(OverflowError, match="position 2"):
+        nanopd.Int64Array([1, None, 2**63])
+
+def test_from_arrow():
+    arr = nanopd.Int64Array([1, None, 3])
+    result = nanopd.Int64Array.from_arrow(arr)
+    assert result.to_pylist() == [1, None, 3]
+
+
+def test_from_arrow_pyarrow():
+    pa = pytest.importorskip("pyarrow")
+    arr = nanopd.Int64Array.from_arrow(pa.array([1, None, 3]))
+    assert arr.to_pylist() == [1, None, 3]
+    assert pa.array(arr).to_pylist() == [1, None, 3]
+
+
+def test_sliced_null_count_threads():
+    from concurrent.futures import ThreadPoolExecutor
+
+    arr = nanopd.Int64Array([1, None] * 50_000)[1:]
+    with ThreadPoolExecutor(4) as pool:
+        results = list(pool.map(lambda _: arr.isna().to_pylist().count(True), range(8)))
+    assert results == [50_000] * 8
+    assert arr.null_count == 50_000
+
+
+def test_to_numpy():
+    np = pytest.importorskip("numpy")
+    arr = nanopd.Int64Array([1, 2, 3, 4])
+    result = arr[1:].to_numpy()
+    assert result.dtype == np.int64
+    assert result.tolist() == [2, 3, 4]
+    assert not result.flags.writeable
+    del arr
+    assert result.tolist() == [2, 3, 4]
+
+    assert np.asarray(nanopd.Int64Array([5, 6])).tolist() == [5, 6]
+    assert nanopd.Int64Array([5]).to_numpy(copy=True).flags.writeable
+
+
+def test_to_numpy_nulls():
+    np = pytest.importorskip("numpy")
+    arr = nanopd.Int64Array([1, None, 3])
+    result = arr.to_numpy()
+    assert result.dtype == object
+    assert result.tolist() == [1, None, 3]
+    assert np.asarray(arr).tolist() == [1, None, 3]
+    assert arr.to_numpy(na_value=-1).tolist() == [1, -1, 3]
+
+    values, mask = arr.to_numpy_masked()
+    assert mask.tolist() == [False, True, False]
+    assert values[~mask].tolist() == [1, 3]
+
+
+def test_to_numpy_dtype():
+    np = pytest.importorskip("numpy")
+    arr = nanopd.Int64Array([1, 2, 3])
+    # the keywords pandas passes from Series.to_numpy
+    result = arr.to_numpy(dtype="float64", copy=False, na_value=None)
+    assert result.dtype == np.float64
+    assert result.tolist() == [1.0, 2.0, 3.0]
+    assert arr.to_numpy(np.int64).dtype == np.int64
+
+    arr = nanopd.Int64Array([1, None, 3])
+    result = arr.to_numpy(dtype=float)
+    assert result.dtype == np.float64
+    assert np.isnan(result[1])
+    assert arr.to_numpy(dtype=object).tolist() == [1, None, 3]
+    assert arr.to_numpy(dtype=float, na_value=-1).tolist() == [1.0, -1.0, 3.0]
+    assert arr.to_numpy(na_value=np.nan).tolist()[0] == 1
+    with pytest.raises(ValueError):
+        arr.to_numpy(dtype="int32")
+
+
+def test_to_numpy_no_default():
+    np = pytest.importorskip("numpy")
+    pd = pytest.importorskip("pandas")
+    no_default = pd.api.extensions.no_default
+    arr = nanopd.Int64Array([1, None, 3])
+    assert arr.to_numpy(na_value=no_default).tolist() == [1, None, 3]
+    result = arr.to_numpy(dtype="float64", copy=False, na_value=no_default)
+    assert result[0] == 1.0
+    assert np.isnan(result[1])
+    result = nanopd.Int64Array([1, 2]).to_numpy(na_value=no_default)
+    assert result.tolist() == [1, 2]
+
+
+def test_array_copy():
+    np = pytest.importorskip("numpy")
+    if np.lib.NumpyVersion(np.__version__) < "2.0.0":
+        pytest.skip("the copy keyword needs numpy 2")
+
+    arr = nanopd.Int64Array([1, 2, 3])
+    assert not np.asarray(arr, copy=False).flags.writeable
+    assert np.asarray(arr, copy=True).flags.writeable
+    assert np.asarray(arr, dtype=np.float64).dtype == np.float64
+    with pytest.raises(ValueError):
+        np.asarray(arr, dtype=np.float64, copy=False)
+    with pytest.raises(ValueError):
+        np.asarray(nanopd.Int64Array([1, None]), copy=False)
+
+
+def test_from_numpy():
+    np = pytest.importorskip("numpy")
+    values = np.array([1, 2, 3], dtype="int64")
+    arr = nanopd.Int64Array.from_numpy(values)
+    del values
+    assert arr.to_pylist() == [1, 2, 3]
+
+    arr = nanopd.Int64Array.from_numpy(
+        np.array([1, 2, 3], dtype="int32"), mask=np.array([False, True, False])
+    )
+    assert arr.to_pylist() == [1, None, 3]
+    assert arr.null_count == 1
+
+    with pytest.raises(ValueError):
+        nanopd.Int64Array.from_numpy(np.array([1, 2]), mask=np.array([True]))
+
+
+def test_copy():
+    arr = nanopd.Int64Array([1, None, 3])
+    assert arr.copy().to_pylist() == [1, None, 3]
+    assert arr.copy(deep=False).to_pylist() == [1, None, 3]
+
+
+def test_concat_same_type_sliced():
+    arr = nanopd.Int64Array([1, None, 3, 4])
+    result = arr[1:]._concat_same_type(arr[2:])
+    assert result.to_pylist() == [None, 3, 4, 3, 4]
+
+
+def test_concat_same_type_sequence():
+    arrs = [nanopd.Int64Array([i, None]) for i in range(100)]
+    result = nanopd.Int64Array._concat_same_type(arrs)
+    assert result.to_pylist() == [x for i in range(100) for x in (i, None)]
+    assert nanopd.Int64Array._concat_same_type([]).to_pylist() == []
+
+
+def test_take():
+    arr = nanopd.Int64Array([1, None, 3])
+    assert arr.take([2, 0, -1]).to_pylist() == [3, 1, 3]
+    assert arr.take([2, -1], allow_fill=True).to_pylist() == [3, None]
+    assert arr.take([2, -1], allow_fill=True, fill_value=42).to_pylist() == [3, 42]
+
+
+def test_eq():
+    arr = nanopd.Int64Array([1, None, 3, 4])
+    other = nanopd.Int64Array([1, 2, None, 5])
+    assert (arr == other).to_pylist() == [True, None, None, False]
+    assert (arr == 3).to_pylist() == [False, None, True, False]
+    assert (arr[1:] == other[:3]).to_pylist() == [None, False, False]
+
+    with pytest.raises(ValueError):
+        arr == other[1:]
+
+    values = list(range(100_000))
+    arr = nanopd.Int64Array(values)
+    assert (arr == 99_999).to_pylist() == [x == 99_999 for x in values]
+
+
+def test_comparisons():
+    arr = nanopd.Int64Array([1, None, 3, -4])
+    other = nanopd.Int64Array([2, 2, 3, -5])
+    assert (arr != other).to_pylist() == [True, None, False, True]
+    assert (arr < other).to_pylist() == [True, None, False, False]
+    assert (arr <= other).to_pylist() == [True, None, True, False]
+    assert (arr > other).to_pylist() == [False, None, False, True]
+    assert (arr >= other).to_pylist() == [False, None, True, True]
+
+    assert (arr != 3).to_pylist() == [True, None, False, True]
+    assert (arr < 3).to_pylist() == [True, None, False, True]
+    assert (arr <= 3).to_pylist() == [True, None, True, True]
+    assert (arr > 1).to_pylist() == [False, None, True, False]
+    assert (arr >= 1).to_pylist() == [True, None, True, False]
+
+    values = list(range(100_000))
+    arr = nanopd.Int64Array(values)
+    assert (arr >= 90_000).to_pylist() == [x >= 90_000 for x in values]
+    assert (arr < arr[::-1]).to_pylist() == [x < 99_999 - x for x in values]
+
+
+def test_getitem_boolean_mask():
+    values = list(range(100_000))
+    arr = nanopd.Int64Array(values)
+    assert arr[arr % 3 == 0].to_pylist() == values[::3]
+    assert arr[arr < 0].to_pylist() == []
+
+
+def test_arithmetic():
+    arr = nanopd.Int64Array([7, None, -7, 3])
+    other = nanopd.Int64Array([2, 1, 2, -2])
+    assert (arr + other).to_pylist() == [9, None, -5, 1]
+    assert (arr - other).to_pylist() == [5, None, -9, 5]
+    assert (arr * other).to_pylist() == [14, None, -14, -6]
+    assert (arr // other).to_pylist() == [3, None, -4, -2]
+    assert (arr % other).to_pylist() == [1, None, 1, -1]
+    assert (-arr).to_pylist() == [-7, None, 7, -3]
+
+    assert (arr + 1).to_pylist() == [8, None, -6, 4]
+    assert (1 - arr).to_pylist() == [-6, None, 8, -2]
+    assert (2 * arr).to_pylist() == [14, None, -14, 6]
+    assert (arr // -2).to_pylist() == [-4, None, 3, -2]
+    assert (10 % arr).to_pylist() == [3, None, -4, 1]
+
+    with pytest.raises(ValueError):
+        arr + other[1:]
+
+
+def test_arithmetic_division_by_zero():
+    arr = nanopd.Int64Array([7, None, -7])
+    other = nanopd.Int64Array([0, 0, 2])
+    assert (arr // other).to_pylist() == [None, None, -4]
+    assert (arr % other).to_pylist() == [None, None, 1]
+    assert (arr // 0).to_pylist() == [None, None, None]
+
+
+def test_arithmetic_overflow():
+    big = 2**63 - 1
+    arr = nanopd.Int64Array([big, None])
+    with pytest.raises(OverflowError):
+        arr + 1
+    with pytest.raises(OverflowError):
+        arr * 2
+    with pytest.raises(OverflowError):
+        -(arr - big - big - 1)
+    with pytest.raises(OverflowError):
+        nanopd.Int64Array([-big - 1]) // -1
+
+    result = arr.__add__(1, check_overflow=False)
+    assert result.to_pylist() == [-big - 1, None]
+
+
+def test_sum():
+    arr = nanopd.Int64Array([1, None, 3])
+    assert arr.sum() == 4
+    assert arr.sum(skipna=False) is None
+    assert arr.sum(min_count=3) is None
+    assert nanopd.Int64Array([]).sum() == 0
+
+
+def test_sum_overflow():
+    arr = nanopd.Int64Array([2**63 - 1, 1])
+    with pytest.raises(OverflowError):
+        arr.sum()
+
+    arr = nanopd.Int64Array([2**63 - 1, 1, -2])
+    assert arr.sum() == 2**63 - 2
+
+
+def test_min_max():
+    values = [(i * 7919) % 1000 - 500 if i % 5 else None for i in range(200)]
+    arr = nanopd.Int64Array(values)
+    valid = [x for x in values if x is not None]
+    assert arr.min() == min(valid)
+    assert arr.max() == max(valid)
+    assert arr.min(skipna=False) is None
+    assert arr[1:5].min(skipna=False) == min(values[1:5])
+    assert nanopd.Int64Array([None]).max() is None
+
+
+def test_factorize():
+    arr = nanopd.Int64Array([3, None, 3, -1, 7, -1])
+    locs, uniqs = arr.factorize(size_hint=2)
+    assert locs.to_pylist() == [0, -1, 0, 1, 2, 1]
+    assert uniqs.to_pylist() == [3, -1, 7]
+
+    # hints are clamped to the number of rows
+    for size_hint in (-5, 10**9, 2**63 - 1):
+        locs, uniqs = arr.factorize(size_hint=size_hint)
+        assert locs.to_pylist() == [0, -1, 0, 1, 2, 1]
+
+
+def test_unique():
+    arr = nanopd.Int64Array([3, None, 3, -1, 7, -1])
+    assert arr.unique().to_pylist() == [3, -1, 7]
+    assert arr.unique(sort=True).to_pylist() == [-1, 3, 7]
+
+
+def test_unique_wide_range():
+    values = [2**62, None, -(2**62), 5, 2**62]
+    arr = nanopd.Int64Array(values)
+    assert arr.unique().to_pylist() == [2**62, -(2**62), 5]
+    assert arr.unique(sort=True).to_pylist() == [-(2**62), 5, 2**62]
+
+
+def test_argsort():
+    arr = nanopd.Int64Array([3, None, -(2**62), 3, 2**62, None, 0])
+    assert arr.argsort().to_pylist() == [2, 6, 0, 3, 4, 1, 5]
+    assert arr.argsort(na_position="first").to_pylist() == [1, 5, 2, 6, 0, 3, 4]
+    # ties keep their original order in descending sorts too
+    assert arr.argsort(ascending=False).to_pylist() == [4, 0, 3, 6, 2, 1, 5]
+    assert arr[2:].argsort().to_pylist() == [0, 4, 1, 2, 3]
+
+    with pytest.raises(ValueError):
+        arr.argsort(na_position="middle")
+
+
+def test_sort():
+    values = [(i * 7919) % 1000 - 500 for i in range(1000)] + [None]
+    arr = nanopd.Int64Array(values)
+    expected = sorted(values[:-1])
+    assert arr.sort().to_pylist() == expected + [None]
+    result = arr.sort(ascending=False, na_position="first")
+    assert result.to_pylist() == [None] + expected[::-1]
+
+
+def test_topk():
+    arr = nanopd.Int64Array([5, None, 9, -3, 9, 0, None, -3])
+    values, positions = arr.topk(3)
+    assert values.to_pylist() == [9, 9, 5]
+    assert positions.to_pylist() == [2, 4, 0]
+
+    values, positions = arr.topk(2, largest=False)
+    assert values.to_pylist() == [-3, -3]
+    assert positions.to_pylist() == [3, 7]
+
+    values, positions = arr[1:].topk(10)
+    assert values.to_pylist() == [9, 9, 0, -3, -3]
+    assert positions.to_pylist() == [1, 3, 4, 2, 6]
+
+    assert arr.topk(0)[0].to_pylist() == []
+    with pytest.raises(ValueError):
+        arr.topk(-1)
+
+
+def test_topk_many_morsels():
+    values = [(i * 7919) % 100_000 for i in range(100_000)]
+    arr = nanopd.Int64Array(values)
+    result, positions = arr.topk(5)
+    assert result.to_pylist() == [99_999, 99_998, 99_997, 99_996, 99_995]
+    assert [values[i] for i in positions.to_pylist()] == result.to_pylist()
+
+
+def test_pad_or_backfill():
+    arr = nanopd.Int64Array([None, 1, None, 3, None])
+    assert arr._pad_or_backfill("pad").to_pylist() == [None, 1, 1, 3, 3]
+    assert arr._pad_or_backfill("backfill").to_pylist() == [1, 1, 3, 3, None]
+    assert arr.interpolate().to_pylist() == [None, 1, 1, 3, 3]
+    assert arr.dropna().to_pylist() == [1, 3]
+
+
+def test_set_num_threads():
+    previous = nanopd.get_num_threads()
+    try:
+        nanopd.set_num_threads(3)
+        assert nanopd.get_num_threads() == 3
+        nanopd.set_num_threads(0)
+        assert nanopd.get_num_threads() >= 1
+        with pytest.raises(ValueError):
+            nanopd.set_num_threads(-1)
+    finally:
+        nanopd.set_num_threads(previous)
+
+
+@pytest.mark.parametrize("num_threads", [1, 4])
+def test_reductions_large_parallel(num_threads):
+    previous = nanopd.get_num_threads()
+    nanopd.set_num_threads(num_threads)
+    try:
+        values = [None if i % 7 == 0 else i - 50_000 for i in range(100_000)]
+        arr = nanopd.Int64Array(values)
+        valid = [x for x in values if x is not None]
+        assert arr.sum() == sum(valid)
+        assert arr.min() == min(valid)
+        assert arr.max() == max(valid)
+        assert arr[65:].sum() == sum(x for x in values[65:] if x is not None)
+        assert arr.take(list(range(99_999, -1, -1))).to_pylist() == values[::-1]
+    finally:
+        nanopd.set_num_threads(previous)
+
+
+@pytest.mark.skipif(not hasattr(os, "fork"), reason="requires os.fork")
+def test_parallel_after_fork():
+    previous = nanopd.get_num_threads()
+    nanopd.set_num_threads(4)
+    try:
+        arr = nanopd.Int64Array(list(range(200_000)))
+        expected = sum(range(200_000))
+        # starts the pool in the parent, whose workers the child will not have
+        assert arr.sum() == expected
+
+        pid = os.fork()
+        if pid == 0:
+            ok = arr.sum() == expected and (arr + 1).sum() == expected + 200_000
+            os._exit(0 if ok else 1)
+
+        deadline = time.monotonic() + 60
+        while True:
+            done, status = os.waitpid(pid, os.WNOHANG)
+            if done:
+                break
+            if time.monotonic() > deadline:
+                os.kill(pid, signal.SIGKILL)
+                os.waitpid(pid, 0)
+                pytest.fail("parallel kernel hung in the forked child")
+            time.sleep(0.05)
+        assert os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0
+    finally:
+        nanopd.set_num_threads(previous)
@@ -13,6 +13,21 @@ def test_from_sequence():
     assert arr[3] == "baz"
 
 
+
+def test_constructor_encodings():
+    values = ["ascii", None, "caf\u00e9", "\U0001f600", ""] * 30
+    arr = nanopd.StringArray(tuple(values))
+    assert arr.to_pylist() == values
+    assert arr.null_count == 30
+
+
+def test_constructor_invalid_value():
+    with pytest.raises(TypeError, match="position 2"):
+        nanopd.StringArray(["foo", None, 1])
+
+    with pytest.raises(ValueError, match="position 1"):
+        nanopd.StringArray(["foo", "\ud800"])
+
 def test_from_factorized():
     # TODO: this is not really a classmethod
     # See https://github.com/wjakob/nanobind/discussions/416
@@ -23,6 +38,29 @@ def test_from_factorized():
     assert result.to_pylist() == ["foo", None, "bar", "foo", None]
 
 
+def test_from_arrow():
+    arr = nanopd.StringArray(["foo", None, "bar"])
+    result = nanopd.StringArray.from_arrow(arr)
+    assert result.to_pylist() == ["foo", None, "bar"]
+
+
+def test_from_arrow_pyarrow():
+    pa = pytest.importorskip("pyarrow")
+    arr = nanopd.StringArray.from_arrow(pa.array(["foo", None, "bar"]))
+    assert arr.to_pylist() == ["foo", None, "bar"]
+    assert arr.null_count == 1
+
+    result = pa.array(arr)
+    assert result.type == pa.large_string()
+    assert result.to_pylist() == ["foo", None, "bar"]
+
+
+def test_from_arrow_wrong_type():
+    arr = nanopd.Int64Array([1, 2])
+    with pytest.raises(ValueError, match="Cannot create StringArray"):
+        nanopd.StringArray.from_arrow(arr)
+
+
 def test_getitem():
     arr = nanopd.StringArray(["foo", None, "bar", "baz"])
     assert arr[0] == "foo"
@@ -31,6 +69,21 @@ def test_getitem():
     assert arr[3] == "baz"
 
 
+
+def test_getitem_non_ascii():
+    arr = nanopd.StringArray(["caf\u00e9", "\U0001f600"])
+    assert arr[0] == "caf\u00e9"
+    assert arr[-1] == "\U0001f600"
+
+
+def test_to_pylist_repeated_values():
+    values = ["low", "high", None, "caf\u00e9", "x" * 100] * 50
+    result = nanopd.StringArray(values).to_pylist()
+    assert result == values
+    # short repeated values share one str object
+    assert result[0] is result[5]
+    assert result[3] is result[8]
+
 def test_getitem_slice():
     arr = nanopd.StringArray(["foo", None, "bar", "baz"])
     result = arr[:2]
@@ -38,6 +91,16 @@ def test_getitem_slice():
     assert result[0] == "foo"
     assert result[1] is None
 
+def test_getitem_slice_is_view():
+    arr = nanopd.StringArray(["foo", None, "bar", "baz"])
+    result = arr[1:3]
+    del arr
+    assert result.to_pylist() == [None, "bar"]
+    assert result.null_count == 1
+    assert result[1:].to_pylist() == ["bar"]
+    assert result[1:].null_count == 0
+
+
 def test_getitem_slice_neg_start():
     arr = nanopd.StringArray(["foo", None, "bar", "baz"])
     result = arr[-2:]
@@ -66,6 +129,55 @@ def test_eq():
     assert result.to_pylist() == [True, None, False, True, True]
 
 
+def test_eq_scalar():
+    arr = nanopd.StringArray(["foo", None, "fo", "foo", "üàéµ"])
+    assert (arr == "foo").to_pylist() == [True, None, False, True, False]
+    assert (arr[2:] == "foo").to_pylist() == [False, True, False]
+
+    arr = nanopd.StringArray(["foo", "bar"] * 50_000)
+    result = arr == "bar"
+    assert result.null_count == 0
+    assert result.to_pylist() == [False, True] * 50_000
+
+
+def test_comparisons():
+    arr = nanopd.StringArray(["a", None, "ab", "b", "ü"])
+    other = nanopd.StringArray(["ab", "a", "ab", "a", "z"])
+    assert (arr != other).to_pylist() == [True, None, False, True, True]
+    assert (arr < other).to_pylist() == [True, None, False, False, False]
+    assert (arr <= other).to_pylist() == [True, None, True, False, False]
+    assert (arr > other).to_pylist() == [False, None, False, True, True]
+    assert (arr >= other).to_pylist() == [False, None, True, True, True]
+
+    assert (arr < "b").to_pylist() == [True, None, True, False, False]
+    assert (arr >= "ab").to_pylist() == [False, None, True, True, True]
+
+
+def test_getitem_boolean_mask():
+    arr = nanopd.StringArray(["foo", None, "bar", "baz"])
+    mask = nanopd.BoolArray([True, True, None, True])
+    assert arr[mask].to_pylist() == ["foo", None, "baz"]
+    assert arr[1:][mask[1:]].to_pylist() == [None, "baz"]
+    assert arr[arr == "bar"].to_pylist() == ["bar"]
+
+    with pytest.raises(IndexError):
+        arr[mask[1:]]
+
+
+def test_getitem_numpy_mask():
+    np = pytest.importorskip("numpy")
+    arr = nanopd.StringArray(["foo", None, "bar", "baz"])
+    assert arr[np.array([False, True, True, False])].to_pylist() == [None, "bar"]
+
+    values = [str(i) for i in range(100_000)]
+    arr = nanopd.StringArray(values)
+    mask = np.arange(100_000) % 7 == 0
+    assert arr[mask].to_pylist() == values[::7]
+
+    with pytest.raises(IndexError):
+        arr[mask[1:]]
+
+
 def test_nbytes():
     arr = nanopd.StringArray(["foo", "bar", "baz"])
     assert arr.nbytes == 32
@@ -81,6 +193,12 @@ def test_isna():
     result = arr.isna()
     assert result.to_pylist() == [False, True, False, True, False]
 
+def test_isna_sliced():
+    arr = nanopd.StringArray(["foo", None, "bar", None, "baz"])
+    result = arr[1:].isna()
+    assert result.to_pylist() == [True, False, True, False]
+
+
 def test_isna_no_missing():
     arr = nanopd.StringArray(["foo", "bar", "baz"])
     result = arr.isna()
@@ -104,12 +222,56 @@ def test_negative_take():
     assert result.to_pylist() == ["foo", "baz", "baz", "foo"]
 
 
+def test_take_allow_fill():
+    arr = nanopd.StringArray(["foo", None, "bar", None, "baz"])
+    result = arr.take([0, -1, 2], allow_fill=True)
+    assert result.to_pylist() == ["foo", None, "bar"]
+
+    result = arr.take([0, -1, 2], allow_fill=True, fill_value="filled")
+    assert result.to_pylist() == ["foo", "filled", "bar"]
+
+    with pytest.raises(ValueError):
+        arr.take([0, -2], allow_fill=True)
+
+
+def test_take_out_of_bounds():
+    arr = nanopd.StringArray(["foo", None, "bar"])
+    with pytest.raises(IndexError):
+        arr.take([3])
+
+
+def test_take_int64array():
+    arr = nanopd.StringArray(["foo", None, "bar", None, "baz"])
+    result = arr.take(nanopd.Int64Array([4, 0, 2]))
+    assert result.to_pylist() == ["baz", "foo", "bar"]
+
+
+def test_take_ndarray():
+    np = pytest.importorskip("numpy")
+    arr = nanopd.StringArray(["foo", None, "bar", None, "baz"])
+    result = arr.take(np.array([4, 1, 0], dtype="int64"))
+    assert result.to_pylist() == ["baz", None, "foo"]
+
+
 def test_copy():
     arr = nanopd.StringArray(["foo", None, "bar", None, "baz"])
     result = arr.copy()
     assert arr.to_pylist() == result.to_pylist()
 
 
+def test_copy_sliced():
+    arr = nanopd.StringArray(["foo", None, "bar", None, "baz"])
+    result = arr[1:4].copy()
+    assert result.to_pylist() == [None, "bar", None]
+
+
+def test_copy_shallow():
+    arr = nanopd.StringArray(["foo", None, "bar", None, "baz"])
+    result = arr.copy(deep=False)
+    del arr
+    assert result.to_pylist() == ["foo", None, "bar", None, "baz"]
+
+
 def test_concat_same_type():
     arr = nanopd.StringArray(["foo", None, "bar", None, "baz"])
     other = nanopd.StringArray([None, "quz", None, "quux"])
@@ -119,6 +281,16 @@ def test_concat_same_type():
     assert result.to_pylist() == expected
 
 
+def test_concat_same_type_sequence():
+    arr = nanopd.StringArray(["foo", None, "bar"])
+    to_concat = [arr[1:], nanopd.StringArray([]), nanopd.StringArray(["baz"])]
+    result = nanopd.StringArray._concat_same_type(to_concat)
+    assert result.to_pylist() == [None, "bar", "baz"]
+
+    result = arr._concat_same_type([arr[2:], arr[:1]])
+    assert result.to_pylist() == ["foo", None, "bar", "bar", "foo"]
+
+
 def test_interpolate():
     arr = nanopd.StringArray([None, "foo", None, "bar", None, "baz"])
     result = arr.interpolate()
@@ -167,6 +339,19 @@ def test_pad_or_backfill_backfill():
     assert result.to_pylist() == expected
 
 
+def test_gathers_on_slice():
+    arr = nanopd.StringArray(["x", None, "foo", None, "", None, "baz", "y"])[1:7]
+    assert arr.fillna("-").to_pylist() == ["-", "foo", "-", "", "-", "baz"]
+    assert arr._pad_or_backfill("pad").to_pylist() == [
+        None, "foo", "foo", "", "", "baz"
+    ]
+    assert arr._pad_or_backfill("backfill").to_pylist() == [
+        "foo", "foo", "", "", "baz", "baz"
+    ]
+    assert arr.dropna().to_pylist() == ["foo", "", "baz"]
+    assert arr._concat_same_type(arr).to_pylist() == arr.to_pylist() * 2
+
+
 def test_dropna():
     arr = nanopd.StringArray([None, "foo", None, "bar", None, "baz"])
     result = arr.dropna()
@@ -178,10 +363,39 @@ def test_unique():
     arr = nanopd.StringArray(["foo", None, "foo", "üàéµ", "üàéµ"])
     result = arr.unique()
 
-    expected = {"foo", "üàéµ"}
-    assert len(expected) == len(result)
-    for i in range(len(expected)):
-        expected.remove(result[i])
+    assert result.to_pylist() == ["foo", "üàéµ"]
+
+
+def test_unique_sort():
+    arr = nanopd.StringArray(["foo", "bar", None, "baz", "bar"])
+    assert arr.unique().to_pylist() == ["foo", "bar", "baz"]
+    assert arr.unique(sort=True).to_pylist() == ["bar", "baz", "foo"]
+
+
+def test_argsort():
+    arr = nanopd.StringArray(["foo", None, "", "fo", "üàéµ", "foo", "bar"])
+    assert arr.argsort().to_pylist() == [2, 6, 3, 0, 5, 4, 1]
+    assert arr.argsort(ascending=False).to_pylist() == [4, 0, 5, 3, 6, 2, 1]
+    assert arr.argsort(na_position="first").to_pylist() == [1, 2, 6, 3, 0, 5, 4]
+
+
+def test_sort_shared_prefixes():
+    values = ["prefix" * 10 + str(i % 97) for i in range(500)] + [None]
+    arr = nanopd.StringArray(values)
+    expected = sorted(values[:-1])
+    assert arr.sort().to_pylist() == expected + [None]
+    assert arr.sort(ascending=False).to_pylist() == expected[::-1] + [None]
+
+
+def test_topk():
+    arr = nanopd.StringArray(["pear", None, "apple", "fig", "pear", "üàéµ"])
+    values, positions = arr.topk(3)
+    assert values.to_pylist() == ["üàéµ", "pear", "pear"]
+    assert positions.to_pylist() == [5, 0, 4]
+
+    values, positions = arr.topk(2, largest=False)
+    assert values.to_pylist() == ["apple", "fig"]
+    assert positions.to_pylist() == [2, 3]
 
 
 def test_factorize():
@@ -192,6 +406,15 @@ def test_factorize():
     assert uniqs.to_pylist() == ["foo", "üàéµ"]
 
 
+def test_factorize_many_values():
+    values = [f"value_{i % 3000}" for i in range(10_000)]
+    arr = nanopd.StringArray(values)
+    locs, uniqs = arr.factorize()
+
+    assert len(uniqs) == 3000
+    assert uniqs.take(locs.to_pylist()).to_pylist() == values
+
+
 # str accessor methods
 def test_len():
     arr = nanopd.StringArray(["foo", None, "bar", "üàéµ", "baz"])
@@ -217,6 +440,54 @@ def test_capitalize():
     assert result.to_pylist() == ["Foo", None, "Bar", "Üàéµ", "BAZ"]
 
 
+def test_case_ascii_only():
+    values = ["hello World 123", None, "", "ABCDEFGHIJKLMNOPQRSTUVWXYZ@[`{"]
+    arr = nanopd.StringArray(values)
+    assert arr.lower().to_pylist() == [
+        None if x is None else x.lower() for x in values
+    ]
+    assert arr.upper().to_pylist() == [
+        None if x is None else x.upper() for x in values
+    ]
+    assert arr.capitalize().to_pylist() == [
+        "Hello World 123",
+        None,
+        "",
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ@[`{",
+    ]
+    assert arr[1:].upper().to_pylist() == arr.upper().to_pylist()[1:]
+
+
+def test_predicates_ascii_only():
+    arr = nanopd.StringArray(["abc", "ABC", "a1", "123", " ", "\t", "", None])
+    assert arr.isalnum().to_pylist() == [
+        True, True, True, True, False, False, True, None
+    ]
+    assert arr.isalpha().to_pylist() == [
+        True, True, False, False, False, False, True, None
+    ]
+    assert arr.isdigit().to_pylist() == [
+        False, False, False, True, False, False, True, None
+    ]
+    assert arr.isspace().to_pylist() == [
+        False, False, False, False, True, False, True, None
+    ]
+    assert arr.islower().to_pylist() == [
+        True, False, False, False, False, False, True, None
+    ]
+    assert arr.isupper().to_pylist() == [
+        False, True, False, False, False, False, True, None
+    ]
+
+
+def test_case_length_changes():
+    # U+0131 (2 bytes) upper cases to "I" and U+023F (2 bytes) to U+2C7E
+    # (3 bytes), so the output can shrink or grow relative to the input
+    arr = nanopd.StringArray(["\u0131x", None, "\u023f", "ab\u023f"])
+    assert arr.upper().to_pylist() == ["IX", None, "\u2c7e", "AB\u2c7e"]
+    assert arr.capitalize().to_pylist() == ["Ix", None, "\u2c7e", "Ab\u023f"]
+
+
 def test_isalnum():
     arr = nanopd.StringArray(["foo", None, "üàéµ", "bar!!", "42", " "])
     result = arr.isalnum()
@@ -306,3 +577,27 @@ def test_dtype_is_numeric():
 def test_dtype_is_boolean():
     arr = nanopd.StringArray(["FOO", None, "foo", "ÜÀÉΜ", "üàéµ"])
     assert not arr.dtype.is_boolean
+
+
+@pytest.mark.parametrize("num_threads", [1, 4])
+def test_kernels_large_parallel(num_threads):
+    previous = nanopd.get_num_threads()
+    nanopd.set_num_threads(num_threads)
+    try:
+        # "ſ" upper cases to one byte fewer, so morsels change size
+        values = ["fOo", None, "üàéµ", "bar1", "", "ſa"] * 20_000
+        arr = nanopd.StringArray(values)
+        assert arr.upper().to_pylist() == [
+            None if x is None else x.upper() for x in values
+        ]
+        assert arr.len().to_pylist() == [
+            None if x is None else len(x) for x in values
+        ]
+        assert arr.isalpha().to_pylist() == [
+            None if x is None else (x == "" or x.isalpha()) for x in values
+        ]
+        assert arr[3:].lower().to_pylist() == [
+            None if x is None else x.lower() for x in values[3:]
+        ]
+    finally:
+        nanopd.set_num_threads(previous)
@@ -0,0 +1,123 @@
+import pytest
+
+import nanopandas as nanopd
+
+VALUES = ["short", None, "a string longer than twelve bytes", "", "café", "short"]
+
+
+def test_round_trip():
+    arr = nanopd.StringViewArray(VALUES)
+    assert len(arr) == 6
+    assert arr.null_count == 1
+    assert arr.to_pylist() == VALUES
+    assert arr.to_string_array().to_pylist() == VALUES
+
+    result = nanopd.StringArray(VALUES).to_string_view()
+    assert result.to_pylist() == VALUES
+
+
+def test_getitem():
+    arr = nanopd.StringViewArray(VALUES)
+    assert arr[0] == "short"
+    assert arr[1] is None
+    assert arr[2] == "a string longer than twelve bytes"
+    assert arr[-2] == "café"
+
+    assert arr[2:4].to_pylist() == VALUES[2:4]
+    assert arr[::2].to_pylist() == VALUES[::2]
+
+    mask = nanopd.BoolArray([True, False, True, False, False, True])
+    assert arr[mask].to_pylist() == ["short", VALUES[2], "short"]
+
+    with pytest.raises(IndexError):
+        arr[6]
+
+
+def test_take():
+    arr = nanopd.StringViewArray(VALUES)
+    result = arr.take([2, 0, -1], allow_fill=True)
+    assert result.to_pylist() == [VALUES[2], "short", None]
+
+    fill = "a fill value that does not fit inline"
+    result = arr.take([-1, 2, -1], allow_fill=True, fill_value=fill)
+    assert result.to_pylist() == [fill, VALUES[2], fill]
+
+
+def test_getitem_list_and_numpy_mask():
+    arr = nanopd.StringViewArray(VALUES)
+    result = arr[[2, -1, None, 0]]
+    assert isinstance(result, nanopd.StringViewArray)
+    assert result.to_pylist() == [VALUES[2], "short", None, "short"]
+    assert arr[[]].to_pylist() == []
+    with pytest.raises(IndexError):
+        arr[[6]]
+
+    np = pytest.importorskip("numpy")
+    mask = np.array([False, True, True, False, True, False])
+    result = arr[mask]
+    assert isinstance(result, nanopd.StringViewArray)
+    assert result.to_pylist() == [None, VALUES[2], "café"]
+    with pytest.raises(IndexError):
+        arr[np.array([True])]
+
+
+def test_take_filter_inputs():
+    arr = nanopd.StringViewArray(VALUES)
+    expected = [VALUES[2], VALUES[0], VALUES[-1]]
+    assert arr.take([2, 0, -1]).to_pylist() == expected
+    assert arr.take(nanopd.Int64Array([2, 0, -1])).to_pylist() == expected
+
+    np = pytest.importorskip("numpy")
+    assert arr.take(np.array([2, 0, -1])).to_pylist() == expected
+    mask = arr == "short"
+    assert arr[mask].to_pylist() == ["short", "short"]
+    assert arr[mask.to_numpy(na_value=False)].to_pylist() == ["short", "short"]
+
+
+def test_dtype_and_to_numpy():
+    arr = nanopd.StringViewArray(VALUES)
+    assert str(arr.dtype) == str(nanopd.StringArray(VALUES).dtype)
+
+    np = pytest.importorskip("numpy")
+    result = arr.to_numpy()
+    assert result.dtype == object
+    assert result.tolist() == VALUES
+    assert arr.to_numpy(na_value="").tolist()[1] == ""
+
+
+def test_comparisons():
+    values = ["abcd", "abce", None, "abcd" * 5, "abcd" * 5 + "x", "ab"]
+    arr = nanopd.StringViewArray(values)
+    expected = nanopd.StringArray(values)
+    other = ["abcd", "abcd", "x", "abcd" * 5, "abcd" * 5, "abc"]
+
+    for op in ("__eq__", "__ne__", "__lt__", "__le__", "__gt__", "__ge__"):
+        result = getattr(arr, op)(nanopd.StringViewArray(other))
+        assert result.to_pylist() == getattr(expected, op)(
+            nanopd.StringArray(other)
+        ).to_pylist()
+
+        for scalar in ("abcd", "abcd" * 5):
+            result = getattr(arr, op)(scalar)
+            assert result.to_pylist() == getattr(expected, op)(scalar).to_pylist()
+
+
+def test_factorize_unique():
+    arr = nanopd.StringViewArray(["b" * 20, "a", None, "a", "b" * 20])
+    codes, uniques = arr.factorize()
+    assert codes.to_pylist() == [0, 1, -1, 1, 0]
+    assert uniques.to_pylist() == ["b" * 20, "a"]
+    assert arr.unique(sort=True).to_pylist() == ["a", "b" * 20]
+
+
+def test_sort():
+    values = ["b" * 20, None, "a", "b" * 20 + "a", ""]
+    arr = nanopd.StringViewArray(values)
+    assert arr.argsort().to_pylist() == [4, 2, 0, 3, 1]
+    assert arr.sort(ascending=False).to_pylist() == [
+        "b" * 20 + "a",
+        "b" * 20,
+        "a",
+        "",
+        None,
+    ]